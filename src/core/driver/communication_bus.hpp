@@ -7,6 +7,10 @@
 #include <cstdint>
 #include <inplace_function/inplace_function.hpp>
 
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
 namespace embvm
 {
 /// @addtogroup FrameworkDriver
@@ -226,6 +230,82 @@ class commBus
 		return status;
 	}
 
+#if defined(__cpp_impl_coroutine)
+	/// Awaitable returned by transferAsync().
+	class TransferAwaitable
+	{
+	  public:
+		/** Construct the awaitable.
+		 *
+		 * @param bus The bus which performs the transfer.
+		 * @param op The operation to transfer.
+		 */
+		TransferAwaitable(commBus& bus, TOperation& op) noexcept : bus_(bus), op_(op) {}
+
+		/// The coroutine always suspends.
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		/** Start the transfer. The completion callback resumes the coroutine.
+		 *
+		 * @returns false if the bus is busy, since the callback is not invoked in that case.
+		 *	The coroutine continues immediately and receives TStatus::busy.
+		 */
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			auto status = bus_.transfer(op_, [this, h](TOperation, TStatus result) {
+				status_ = result;
+				h.resume();
+			});
+
+			// Otherwise the callback may have already resumed the coroutine, so this object must
+			// not be accessed
+			if(status == TStatus::busy)
+			{
+				status_ = status;
+				return false;
+			}
+
+			return true;
+		}
+
+		/// @returns the final status of the transfer.
+		TStatus await_resume() const noexcept
+		{
+			return status_;
+		}
+
+	  private:
+		/// The bus which performs the transfer.
+		commBus& bus_;
+		/// The operation to transfer.
+		TOperation& op_;
+		/// The final status of the transfer.
+		TStatus status_ = TStatus::ok;
+	};
+
+	/** Initiate a bus transfer from a coroutine.
+	 *
+	 * The coroutine is suspended until the transfer completes, and resumes wherever the
+	 * transfer callback is invoked. If the bus has a dispatcher, that is the dispatch queue.
+	 *
+	 * @code
+	 * auto status = co_await i2c.transferAsync(op);
+	 * @endcode
+	 *
+	 * @note Requires C++20.
+	 *
+	 * @param op The operation to transfer. Must remain valid until the transfer completes.
+	 * @returns an awaitable which produces the final status of the transfer.
+	 */
+	auto transferAsync(TOperation& op) noexcept -> TransferAwaitable
+	{
+		return TransferAwaitable(*this, op);
+	}
+#endif
+
 	/** Get the current bus status.
 	 *
 	 * @returns The current bus status.
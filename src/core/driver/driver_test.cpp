@@ -9,6 +9,11 @@
 #include <platform.hpp>
 #include <unit_test/driver.hpp> // Unit test driver for abstract class
 
+// Coroutine support requires C++20
+#if defined(__cpp_impl_coroutine)
+#include <dispatch/dispatch_coroutine.hpp>
+#endif
+
 using namespace embvm;
 using namespace test;
 
@@ -325,3 +330,52 @@ TEST_CASE("GPIO tests", "[core/driver/gpio]")
 		CHECK(false == g.get());
 	}
 }
+
+#if defined(__cpp_impl_coroutine)
+
+/// Bus which is always busy. A busy bus does not invoke the transfer callback.
+class BusyBus final : public embvm::spi::commBus
+{
+  protected:
+	auto transfer_(const embvm::spi::op_t& op, const cb_t& callback) noexcept
+		-> embvm::comm::status final
+	{
+		(void)op;
+		(void)callback;
+		return embvm::comm::status::busy;
+	}
+
+	auto baudrate_(embvm::spi::baud_t baud) noexcept -> embvm::spi::baud_t final
+	{
+		return baud;
+	}
+};
+
+using BusFramePool = embutil::DispatchFramePool<512, 1>;
+
+static embutil::DispatchTask<BusFramePool> transfer_on_busy_bus(BusyBus& bus,
+																embvm::spi::op_t& op,
+																embvm::comm::status& result,
+																bool& done)
+{
+	result = co_await bus.transferAsync(op);
+	done = true;
+}
+
+TEST_CASE("Coroutine transfer resumes immediately when the bus is busy", "[core/driver]")
+{
+	BusyBus bus;
+	embvm::spi::op_t op{};
+	auto result = embvm::comm::status::ok;
+	bool done = false;
+
+	CHECK(transfer_on_busy_bus(bus, op, result, done).valid());
+
+	CHECK(true == done);
+	CHECK(embvm::comm::status::busy == result);
+
+	// The coroutine frame was returned to the pool
+	CHECK(1 == BusFramePool::shared().available());
+}
+
+#endif
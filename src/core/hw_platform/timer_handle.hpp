@@ -0,0 +1,298 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef TIMER_HANDLE_HPP_
+#define TIMER_HANDLE_HPP_
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <driver/timer.hpp>
+#include <modm/math/tolerance.hpp>
+#include <utility>
+
+namespace embvm
+{
+/** Handle to a software timer
+ *
+ * TimerHandle represents a handle to an event registration. TimerHandle are created
+ * during the TimerManager::allocate() process.
+ *
+ * Timer managers expose this class as their `TimerHandle` type, so the handle API is the same
+ * for embvm::TimerManager and embvm::TimingWheelTimerManager.
+ *
+ * The handle is used to schedule delays:
+ *	@code
+ *	auto h = tm.allocate();
+ *	h.asyncDelay(std::chrono::milliseconds(1), cb_called);
+ *  @endcode
+ *
+ * The lifetime of the TimerHandle controls the lifetime of the software timer.
+ * If the handle leaves scope, the timer will be automatically unregistered.
+ *
+ * The manager must declare this class as a friend, and provide the following private members:
+ *	- `TQueueHandle`: the iterator type used to identify a timer
+ *	- `TimeUnit_t` and `TimeoutCallback_t`: aliases for the manager's template parameters
+ *	- `timer_list_`: the container of allocated timers
+ *	- `schedule()`, `cancel()`, and `deleteTimer()`
+ *
+ * @tparam TManager The timer manager which owns the software timer.
+ */
+template<typename TManager>
+class SoftwareTimerHandle
+{
+	friend TManager;
+
+	/// @brief Convenience alias for the manager's timer identifier.
+	using TQueueHandle = typename TManager::TQueueHandle;
+
+	/// @brief The manager's time-keeping units.
+	using TTimeUnit = typename TManager::TimeUnit_t;
+
+	/// @brief The manager's storage type for the callback function.
+	using TTimeoutCallback = typename TManager::TimeoutCallback_t;
+
+  public:
+	/// Default constructor which creates an invalid object
+	SoftwareTimerHandle() noexcept : mgr_(nullptr) {}
+
+	/// Destroying the TimerHandle also deletes it from the TimerManager's timer allocation queue
+	~SoftwareTimerHandle() noexcept
+	{
+		destroy();
+	}
+
+	/// @brief Move Constructor
+	SoftwareTimerHandle(SoftwareTimerHandle&& rhs) noexcept : mgr_(rhs.mgr_), handle_(rhs.handle_)
+	{
+		rhs.mgr_ = nullptr;
+		rhs.handle_ = mgr_->timer_list_.end();
+	}
+
+	/// @brief Move assignment operator
+	SoftwareTimerHandle& operator=(SoftwareTimerHandle&& rhs) noexcept
+	{
+		std::swap(mgr_, rhs.mgr_);
+		std::swap(handle_, rhs.handle_);
+		rhs.destroy();
+
+		return *this;
+	}
+
+	/// Delete the copy constructor
+	SoftwareTimerHandle(const SoftwareTimerHandle&) = delete;
+
+	/// Delete the copy assignment operator
+	const SoftwareTimerHandle& operator=(const SoftwareTimerHandle&) = delete;
+
+	/** Check if the TimerHandle is valid.
+	 *
+	 * @returns true if the TimerHandle is valid, false otherwise
+	 */
+	bool valid() const noexcept
+	{
+		return (mgr_ != nullptr && handle_ != mgr_->timer_list_.end());
+	}
+
+	/** Operator bool checks validity.
+	 *
+	 * Operator bool() is used to check that a TimerHandle is valid.
+	 *
+	 * @returns true if the TimerHandle is valid, false otherwise
+	 */
+	operator bool() const noexcept
+	{
+		return valid();
+	}
+
+	/** Destroy the TimerHandle
+	 *
+	 * If the TimerHandle is invalid (i.e. already destroyed), the request will be
+	 * ignored.
+	 */
+	void destroy() noexcept
+	{
+		if(valid())
+		{
+			mgr_->deleteTimer(handle_);
+			handle_ = mgr_->timer_list_.end();
+		}
+	}
+
+	/** Cancel a software timer
+	 *
+	 * Request cancellation for a software timer. The cancellation request is best-effort,
+	 * and the timer may expire before the request is completed.
+	 *
+	 * @pre The TimerHandle is valid
+	 * @post The timer is cancelled, or has expired before cancellation was carried out.
+	 *
+	 * @returns True if the timer was cancelled, false if the timer expired before cancellation.
+	 */
+	bool cancel() noexcept
+	{
+		assert(valid());
+		return mgr_->cancel(handle_);
+	}
+
+	/** Configure a one-shot delay
+	 *
+	 * Configure the software timer to perform a one-shot asynchronous delay. When the timer
+	 *expires, the callback will be called. The timer will be removed from the scheduled queue.
+	 *
+	 * @pre The TimerHandle is valid.
+	 * @post The periodic delay is scheduled.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
+	 *uint64_t)
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
+	 *
+	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
+	 *	For example:
+	 *	@code
+	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
+	 *	@endcode
+	 * @param[in] func Function object that will be registered as the software timer callback.
+	 * @param[in] tolerance The fraction of the delay that the timer may expire late, in
+	 *	modm::Tolerance units (e.g., modm::Tolerance::FivePercent). The timer manager can use this
+	 *	window to expire several timers with a single interrupt.
+	 */
+	template<typename TRep, typename TPeriod>
+	void asyncDelay(const std::chrono::duration<TRep, TPeriod>& delay,
+					const TTimeoutCallback& func,
+					uint16_t tolerance = modm::Tolerance::Exact) noexcept
+	{
+		assert(valid());
+		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
+
+		mgr_->schedule(handle_, convertedDelay, func, embvm::timer::config::oneshot, tolerance);
+	}
+
+	/** Configure a one-shot delay
+	 *
+	 * Configure the software timer to perform a one-shot asynchronous delay. When the timer
+	 *expires, the callback will be called. The timer will be removed from the scheduled queue.
+	 *
+	 * @pre The TimerHandle is valid.
+	 * @post The periodic delay is scheduled.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
+	 *uint64_t)
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
+	 *
+	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
+	 *	For example:
+	 *	@code
+	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
+	 *	@endcode
+	 * @param[in] func R-value function object that will be registered as the software timer
+	 *callback.
+	 * @param[in] tolerance The fraction of the delay that the timer may expire late, in
+	 *	modm::Tolerance units (e.g., modm::Tolerance::FivePercent). The timer manager can use this
+	 *	window to expire several timers with a single interrupt.
+	 */
+	template<typename TRep, typename TPeriod>
+	void asyncDelay(const std::chrono::duration<TRep, TPeriod>& delay,
+					TTimeoutCallback&& func,
+					uint16_t tolerance = modm::Tolerance::Exact) noexcept
+	{
+		assert(valid());
+		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
+
+		mgr_->schedule(handle_, convertedDelay, std::move(func), embvm::timer::config::oneshot,
+					   tolerance);
+	}
+
+	/** Configure a periodic delay
+	 *
+	 * Configure the software timer to perform a periodic delay. When the timer expires, the
+	 *callback will be called adn the timer will be automatically re-added to the scheduled timer
+	 *queue.
+	 *
+	 * @pre The TimerHandle is valid.
+	 * @post The periodic delay is scheduled.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
+	 *uint64_t)
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
+	 *
+	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
+	 *	For example:
+	 *	@code
+	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
+	 *	@endcode
+	 * @param[in] func Function object that will be registered as the software timer callback.
+	 * @param[in] tolerance The fraction of the delay that the timer may expire late, in
+	 *	modm::Tolerance units (e.g., modm::Tolerance::FivePercent). The timer manager can use this
+	 *	window to expire several timers with a single interrupt.
+	 */
+	template<typename TRep, typename TPeriod>
+	void periodicDelay(const std::chrono::duration<TRep, TPeriod>& delay,
+					   const TTimeoutCallback& func,
+					   uint16_t tolerance = modm::Tolerance::Exact) noexcept
+	{
+		assert(valid());
+		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
+
+		mgr_->schedule(handle_, convertedDelay, func, embvm::timer::config::periodic, tolerance);
+	}
+
+	/** Configure a periodic delay
+	 *
+	 * Configure the software timer to perform a periodic delay. When the timer expires, the
+	 *callback will be called adn the timer will be automatically re-added to the scheduled timer
+	 *queue.
+	 *
+	 * @pre The TimerHandle is valid.
+	 * @post The periodic delay is scheduled.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
+	 *uint64_t)
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
+	 *
+	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
+	 *	For example:
+	 *	@code
+	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
+	 *	@endcode
+	 * @param[in] func R-value function object that will be registered as the software timer
+	 *callback.
+	 * @param[in] tolerance The fraction of the delay that the timer may expire late, in
+	 *	modm::Tolerance units (e.g., modm::Tolerance::FivePercent). The timer manager can use this
+	 *	window to expire several timers with a single interrupt.
+	 */
+	template<typename TRep, typename TPeriod>
+	void periodicDelay(const std::chrono::duration<TRep, TPeriod>& delay,
+					   TTimeoutCallback&& func,
+					   uint16_t tolerance = modm::Tolerance::Exact) noexcept
+	{
+		assert(valid());
+		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
+
+		mgr_->schedule(handle_, convertedDelay, std::move(func), embvm::timer::config::periodic,
+					   tolerance);
+	}
+
+  private:
+	/// Private constructor, used by the manager's allocate() to create new TimerHandle instances
+	explicit SoftwareTimerHandle(TManager* mgr) noexcept : mgr_(mgr) {}
+
+  private:
+	/// @brief The owning timer manager
+	TManager* mgr_;
+
+	/// @brief The handle for the delayInfo structure which corresponds with this timer
+	TQueueHandle handle_;
+};
+
+} // namespace embvm
+
+#endif // TIMER_HANDLE_HPP_
@@ -14,6 +14,8 @@
 #endif
 #endif
 
+#include "timer_handle.hpp"
+#include <algorithm>
 #include <cassert>
 #include <driver/timer.hpp>
 #include <etl/list.h>
@@ -21,7 +23,9 @@
 #include <inplace_function/inplace_function.hpp>
 #include <limits>
 #include <list>
+#include <modm/math/tolerance.hpp>
 #include <nop_lock/nop_lock.hpp>
+#include <optional>
 #include <vector>
 
 namespace embvm
@@ -31,6 +35,18 @@ namespace embvm
  * The Timer Manager takes a hardware timer and uses it to produce a
  * number of software timers.
  *
+ * Scheduled timers are stored by absolute deadline in a binary min-heap. The manager keeps a
+ * monotonic time value, which is advanced by the hardware timer count whenever the hardware
+ * timer is stopped or expires. Each timer records its position in the heap, so scheduling,
+ * rescheduling, cancelling, and expiring a timer are all O(log n) operations, and no per-timer
+ * countdown is adjusted on each interrupt.
+ *
+ * Each timer can be scheduled with a tolerance (see modm::Tolerance), which allows the timer to
+ * expire up to that fraction of its delay late. The heap is ordered by the latest allowed expiry,
+ * and the hardware timer is programmed for the earliest of those. When it fires, every timer
+ * whose deadline has passed is expired, so timers with overlapping windows share a single
+ * interrupt. Timers with a tolerance of modm::Tolerance::Exact expire at their deadline.
+ *
  * An alternative structure accomplishing this task is the `callback_timer`
  * provided by ETL in `callback_timer.h`, which uses a `tick()` function:
  *		https://www.etlcpp.com/callback_timer.html
@@ -60,7 +76,7 @@ class TimerManager
 {
   public:
 	/// @brief Consumers interact with the software timer through the TimerHandle class
-	class TimerHandle;
+	using TimerHandle = SoftwareTimerHandle<TimerManager>;
 
 	/// @brief The function prototype for the Dispatcher.
 	/// The dispacher uses inplace_function regardless of static or dynamic memory allocation.
@@ -70,8 +86,14 @@ class TimerManager
 	/// @brief Alias for the time unit representation (e.g., uint32_t, uint64_t)
 	using TimeRep_t = typename TTimeUnit::rep;
 
+	/// @brief The time-keeping units, used by TimerHandle
+	using TimeUnit_t = TTimeUnit;
+
+	/// @brief The callback storage type, used by TimerHandle
+	using TimeoutCallback_t = TTimeoutCallback;
+
 	/// The timer handle can call private TimerManager functions
-	friend class TimerManager::TimerHandle;
+	friend class SoftwareTimerHandle<TimerManager>;
 
 	/** Timer Delay Information
 	 *
@@ -80,22 +102,25 @@ class TimerManager
 	struct delayInfo
 	{
 		delayInfo() noexcept
-			: config(embvm::timer::config::oneshot), current_time(0), target_time(0), cb(),
-			  wait_in_progress(false)
+			: config(embvm::timer::config::oneshot), deadline(0), slack(0), target_time(0), cb(),
+			  wait_in_progress(false), heap_index(0)
 		{
 			// empty body
 		}
 
 		delayInfo(const delayInfo& rhs) noexcept
-			: config(rhs.config), current_time(rhs.current_time), target_time(rhs.target_time),
-			  cb(rhs.cb), wait_in_progress(rhs.wait_in_progress)
+			: config(rhs.config), deadline(rhs.deadline), slack(rhs.slack),
+			  target_time(rhs.target_time), cb(rhs.cb), wait_in_progress(rhs.wait_in_progress),
+			  heap_index(rhs.heap_index)
 		{
 			// empty body
 		}
 
 		delayInfo(delayInfo&& rhs) noexcept
-			: config(std::move(rhs.config)), target_time(std::move(rhs.target_time)),
-			  cb(std::move(rhs.cb)), wait_in_progress(std::move(rhs.wait_in_progress))
+			: config(std::move(rhs.config)), deadline(std::move(rhs.deadline)),
+			  slack(std::move(rhs.slack)), target_time(std::move(rhs.target_time)),
+			  cb(std::move(rhs.cb)), wait_in_progress(std::move(rhs.wait_in_progress)),
+			  heap_index(rhs.heap_index)
 		{
 			rhs.wait_in_progress = false;
 		}
@@ -103,9 +128,12 @@ class TimerManager
 		/// @brief The requested timer configuration
 		embvm::timer::config config;
 
-		/// @brief The adjusted delay time.
-		/// This field allows allowing for delay adjustments due to other timer requests
-		TimeRep_t current_time;
+		/// @brief The absolute time when the timer expires.
+		/// This value is compared against the TimerManager's monotonic time
+		TimeRep_t deadline;
+
+		/// @brief The time after the deadline that the timer is allowed to expire
+		TimeRep_t slack;
 
 		/// @brief The original delay time
 		/// This value is stored particularly for periodic timers
@@ -117,6 +145,16 @@ class TimerManager
 
 		/// @brief Indicates whether the timer is currently running
 		bool wait_in_progress;
+
+		/// @brief The position of the timer in the scheduled queue.
+		/// Only valid while wait_in_progress is true
+		size_t heap_index;
+
+		/// @brief The latest time the timer is allowed to expire
+		TimeRep_t latest() const noexcept
+		{
+			return deadline + slack;
+		}
 	};
 
 	/** Type definition for the underlying timer queue.
@@ -146,18 +184,17 @@ class TimerManager
 		typename std::conditional<(TMaxTimers == 0), std::vector<TQueueHandle>,
 								  etl::vector<TQueueHandle, TMaxTimers>>::type;
 
-	/** Comparator for sorting scheduled timers
+	/** Ordering for the scheduled queue
 	 *
-	 * This comparison operator is used when inserting new timers into the scheduled list.
-	 * Timers must be sorted so that they execute in proper timeout order.
+	 * The scheduled queue is a min-heap, so the timer with the earliest latest-allowed expiry is
+	 * kept at the front of the queue.
+	 *
+	 * @returns true if lhs must expire before rhs.
 	 */
-	struct scheduleQueueCompare
+	static bool expiresBefore(const TQueueHandle& lhs, const TQueueHandle& rhs) noexcept
 	{
-		bool operator()(const TQueueHandle& lhs, const TQueueHandle& rhs) noexcept
-		{
-			return rhs->current_time < lhs->current_time;
-		}
-	};
+		return lhs->latest() < rhs->latest();
+	}
 
   public:
 	/** Create a TimerManager without a dispatcher.
@@ -248,6 +285,33 @@ class TimerManager
 		return handle;
 	}
 
+	/** Get the time remaining until the next timer interrupt.
+	 *
+	 * Tickless idle implementations use this value to decide how long the processor can sleep.
+	 * The hardware timer is programmed for the latest allowed expiry of the earliest timer, so a
+	 * timer scheduled with a tolerance reports the end of its window rather than its deadline.
+	 *
+	 * @returns the time until the hardware timer fires, or an empty optional if no timers are
+	 *	scheduled. A timer which is already due reports a zero duration.
+	 */
+	std::optional<TTimeUnit> nextExpiration() noexcept
+	{
+		std::optional<TTimeUnit> next{};
+
+		scheduled_q_lock_.lock();
+		if(!scheduled_queue_.empty())
+		{
+			TTimeUnit elapsed = timer_hw_.count();
+			auto now = now_ + static_cast<TimeRep_t>(elapsed.count());
+			auto latest = scheduled_queue_.front()->latest();
+
+			next = TTimeUnit(latest > now ? latest - now : 0);
+		}
+		scheduled_q_lock_.unlock();
+
+		return next;
+	}
+
   private:
 	/** TimerManager Default Dispatch Function.
 	 *
@@ -265,7 +329,7 @@ class TimerManager
 	 *
 	 * TimerManager registers its own interrupt with the Timer hardware driver.
 	 * When the timer interrupt fires, we account for the time that has elapsed,
-	 * clear all scheduled timers, and restart the timer hardware with the next
+	 * clear all expired timers, and restart the timer hardware with the next
 	 * timeout request.
 	 *
 	 * Note that this must work with an interrupt bottom-half handler because locking
@@ -275,13 +339,15 @@ class TimerManager
 	{
 		auto count = timer_hw_.count();
 
-		adjustScheduledTimerCount(count);
+		advanceTime(count);
 		clearExpiredTimers();
 		startNextTimer();
 	}
 
-	/**
+	/** Add a timer to the scheduled queue.
 	 *
+	 * New timers are pushed onto the heap. If the timer is already scheduled, its deadline has
+	 * changed in place, so it is moved to its new position. Both are O(log n).
 	 */
 	void addToScheduledQueue(TQueueHandle handle) noexcept
 	{
@@ -295,21 +361,119 @@ class TimerManager
 			}
 
 			scheduled_q_lock_.lock();
-			scheduled_queue_.push_back(handle);
+			pushScheduledQueue(handle);
 			scheduled_q_lock_.unlock();
 
 			handle->wait_in_progress = true;
 		}
+		else
+		{
+			scheduled_q_lock_.lock();
+			updateScheduledQueue(handle->heap_index);
+			scheduled_q_lock_.unlock();
+		}
+	}
+
+	/// Store a timer at a position in the heap, and record the position in the timer.
+	void placeScheduledQueue(size_t index, TQueueHandle handle) noexcept
+	{
+		scheduled_queue_[index] = handle;
+		handle->heap_index = index;
+	}
+
+	/// Move the timer at index toward the front of the heap until its parent expires first.
+	void siftUpScheduledQueue(size_t index) noexcept
+	{
+		auto handle = scheduled_queue_[index];
+
+		while(index > 0)
+		{
+			auto parent = (index - 1) / 2;
+
+			if(!expiresBefore(handle, scheduled_queue_[parent]))
+			{
+				break;
+			}
+
+			placeScheduledQueue(index, scheduled_queue_[parent]);
+			index = parent;
+		}
+
+		placeScheduledQueue(index, handle);
+	}
+
+	/// Move the timer at index toward the back of the heap until it expires before its children.
+	void siftDownScheduledQueue(size_t index) noexcept
+	{
+		auto handle = scheduled_queue_[index];
+		auto size = scheduled_queue_.size();
+
+		while(true)
+		{
+			auto child = (2 * index) + 1;
+
+			if(child >= size)
+			{
+				break;
+			}
+
+			if(child + 1 < size &&
+			   expiresBefore(scheduled_queue_[child + 1], scheduled_queue_[child]))
+			{
+				child++;
+			}
+
+			if(!expiresBefore(scheduled_queue_[child], handle))
+			{
+				break;
+			}
+
+			placeScheduledQueue(index, scheduled_queue_[child]);
+			index = child;
+		}
 
-		sortScheduledQueue();
+		placeScheduledQueue(index, handle);
+	}
+
+	/// Restore the heap after the expiry of the timer at index has changed.
+	void updateScheduledQueue(size_t index) noexcept
+	{
+		if(index > 0 && expiresBefore(scheduled_queue_[index], scheduled_queue_[(index - 1) / 2]))
+		{
+			siftUpScheduledQueue(index);
+		}
+		else
+		{
+			siftDownScheduledQueue(index);
+		}
+	}
+
+	void pushScheduledQueue(TQueueHandle handle) noexcept
+	{
+		scheduled_queue_.push_back(handle);
+		siftUpScheduledQueue(scheduled_queue_.size() - 1);
+	}
+
+	/// Remove the timer at index from the heap. The last timer takes its place.
+	void removeScheduledQueue(size_t index) noexcept
+	{
+		auto last = scheduled_queue_.size() - 1;
+
+		if(index != last)
+		{
+			placeScheduledQueue(index, scheduled_queue_[last]);
+			scheduled_queue_.pop_back();
+			updateScheduledQueue(index);
+		}
+		else
+		{
+			scheduled_queue_.pop_back();
+		}
 	}
 
 	void popScheduledQueueFront() noexcept
 	{
-		// Move to end
-		std::pop_heap(scheduled_queue_.begin(), scheduled_queue_.end(), scheduleQueueCompare());
-		// and remove the last element
-		scheduled_queue_.pop_back();
+		removeScheduledQueue(0);
 	}
 
 	void lockAndPopScheduledQueueFront() noexcept
@@ -319,19 +483,17 @@ class TimerManager
 		scheduled_q_lock_.unlock();
 	}
 
-	void adjustScheduledTimerCount(TTimeUnit time_base) noexcept
+	/** Advance the monotonic time by the time elapsed on the hardware timer.
+	 *
+	 * The hardware timer only runs while timers are scheduled, so the elapsed time is ignored
+	 * when the scheduled queue is empty.
+	 */
+	void advanceTime(TTimeUnit time_base) noexcept
 	{
 		scheduled_q_lock_.lock();
-		for(auto& s : scheduled_queue_)
+		if(!scheduled_queue_.empty())
 		{
-			if(time_base.count() <= s->current_time)
-			{
-				s->current_time -= time_base.count();
-			}
-			else
-			{
-				s->current_time = 0;
-			}
+			now_ += time_base.count();
 		}
 		scheduled_q_lock_.unlock();
 	}
@@ -341,7 +503,10 @@ class TimerManager
 		if(!scheduled_queue_.empty())
 		{
 			scheduled_q_lock_.lock();
-			timer_hw_.restart(scheduled_queue_[0]->current_time);
+			// The next timer may already be due (e.g., the hardware count overshot the period
+			// while the interrupt was pending), in which case the timer fires immediately
+			auto latest = scheduled_queue_[0]->latest();
+			timer_hw_.restart(latest > now_ ? latest - now_ : 0);
 			scheduled_q_lock_.unlock();
 		}
 	}
@@ -357,15 +522,16 @@ class TimerManager
 	}
 
 	void schedule(TQueueHandle handle, TTimeUnit delay, const TTimeoutCallback& func,
-				  embvm::timer::config config) noexcept
+				  embvm::timer::config config, uint16_t tolerance) noexcept
 	{
 		auto time_base = stopRunningTimer();
 
-		adjustScheduledTimerCount(time_base);
+		advanceTime(time_base);
 
 		handle->config = config;
 		handle->target_time = delay.count();
-		handle->current_time = delay.count();
+		handle->deadline = now_ + delay.count();
+		handle->slack = toSlack(delay, tolerance);
 		handle->cb = func;
 
 		addToScheduledQueue(handle);
@@ -374,15 +540,16 @@ class TimerManager
 	}
 
 	void schedule(TQueueHandle handle, TTimeUnit delay, TTimeoutCallback&& func,
-				  embvm::timer::config config) noexcept
+				  embvm::timer::config config, uint16_t tolerance) noexcept
 	{
 		auto time_base = stopRunningTimer();
 
-		adjustScheduledTimerCount(time_base);
+		advanceTime(time_base);
 
 		handle->config = config;
 		handle->target_time = delay.count();
-		handle->current_time = delay.count();
+		handle->deadline = now_ + delay.count();
+		handle->slack = toSlack(delay, tolerance);
 		handle->cb = std::move(func);
 
 		addToScheduledQueue(handle);
@@ -390,6 +557,21 @@ class TimerManager
 		startNextTimer();
 	}
 
+	/** Convert a tolerance to the time a timer may expire after its deadline.
+	 *
+	 * Integer math is used instead of modm::Tolerance::isValueInTolerance(), which uses
+	 * floating point, since this runs for every scheduled timer.
+	 *
+	 * @param delay The timer delay.
+	 * @param tolerance The tolerance in modm::Tolerance units (1/1000 of the delay).
+	 */
+	static auto toSlack(TTimeUnit delay, uint16_t tolerance) noexcept -> TimeRep_t
+	{
+		auto t = static_cast<TimeRep_t>(std::min(tolerance, modm::Tolerance::DontCare));
+
+		return static_cast<TimeRep_t>(delay.count()) * t / modm::Tolerance::DontCare;
+	}
+
 	/// Returns false if no wait was scheduled or if the callback was already called
 	/// Returns true if cancelled successfully
 	bool cancel(TQueueHandle handle) noexcept
@@ -401,9 +583,9 @@ class TimerManager
 			// Check if the timer is currently running
 			if(handle == scheduled_queue_.front())
 			{
-				// Stop the timer and update the counts for the structures
+				// Stop the timer and update the monotonic time
 				auto count = stopRunningTimer();
-				adjustScheduledTimerCount(count);
+				advanceTime(count);
 
 				// Remove the element from the heap and start the next timer
 				lockAndPopScheduledQueueFront();
@@ -414,13 +596,14 @@ class TimerManager
 			}
 			else
 			{
-				// Remove from list
+				// Remove from the heap
 				scheduled_q_lock_.lock();
-				auto it = std::find(scheduled_queue_.begin(), scheduled_queue_.end(), handle);
-				assert(it != scheduled_queue_.end());
-				scheduled_queue_.erase(it);
+				assert(scheduled_queue_[handle->heap_index] == handle);
+				removeScheduledQueue(handle->heap_index);
 				scheduled_q_lock_.unlock();
 			}
+
+			handle->wait_in_progress = false;
 			canceled = true;
 		}
 
@@ -429,56 +612,55 @@ class TimerManager
 
 	void deleteTimer(TQueueHandle handle) noexcept
 	{
+		// A scheduled timer must leave the heap before its storage is released
+		cancel(handle);
+
 		timer_list_lock_.lock();
 		timer_list_.erase(handle);
 		timer_list_lock_.unlock();
 	}
 
-	void sortScheduledQueue() noexcept
-	{
-		scheduled_q_lock_.lock();
-		std::make_heap(scheduled_queue_.begin(), scheduled_queue_.end(), scheduleQueueCompare());
-		scheduled_q_lock_.unlock();
-	}
-
+	/** Dispatch all timers whose deadline has passed.
+	 *
+	 * Expired timers are popped from the heap in order of their latest allowed expiry. A timer
+	 * whose deadline has passed, but which is behind a timer that is not due yet, is expired by a
+	 * later interrupt before its own latest allowed expiry. Periodic timers are pushed back
+	 * with their next deadline, which is computed from the previous deadline so that the period
+	 * does not drift. If a periodic timer has fallen behind, the missed periods are skipped.
+	 */
 	void clearExpiredTimers() noexcept
 	{
-		int expired_count = 0;
-
 		scheduled_q_lock_.lock();
 
-		for(auto& entry : scheduled_queue_)
+		while(!scheduled_queue_.empty() && scheduled_queue_.front()->deadline <= now_)
 		{
-			if(entry->wait_in_progress && entry->current_time == 0)
+			auto entry = scheduled_queue_.front();
+			auto callback = entry->cb;
+
+			popScheduledQueueFront();
+
+			// Oneshot timers are removed - periodic timers are rescheduled
+			if(entry->config == embvm::timer::config::periodic)
 			{
-				auto callback = entry->cb;
+				auto period = std::max<TimeRep_t>(entry->target_time, 1);
 
-				// Oneshot timers are removed - periodic timers stay in the list
-				if(entry->config == embvm::timer::config::periodic)
+				entry->deadline += period;
+				if(entry->deadline <= now_)
 				{
-					entry->current_time = entry->target_time;
-				}
-				else
-				{
-					entry->wait_in_progress = false;
-					expired_count++;
+					entry->deadline = now_ + period;
 				}
 
-				if(callback)
-				{
-					dispatcher_(callback);
-				}
+				pushScheduledQueue(entry);
 			}
 			else
 			{
-				break;
+				entry->wait_in_progress = false;
 			}
-		}
 
-		while(expired_count > 0)
-		{
-			popScheduledQueueFront();
-			expired_count--;
+			if(callback)
+			{
+				dispatcher_(callback);
+			}
 		}
 
 		scheduled_q_lock_.unlock();
@@ -492,254 +674,8 @@ class TimerManager
 	TLock scheduled_q_lock_;
 	TLock timer_list_lock_;
 	TTimerDevice& timer_hw_;
-};
-
-#pragma mark - Timer Manager Handle -
-
-/** Handle to a software timer
- *
- * TimerHandle represents a handle to an event registration. TimerHandle are created
- * during the TimerManager::allocate() process.
- *
- * The handle is used to schedule delays:
- *	@code
- *	auto h = tm.allocate();
- *	h.asyncDelay(std::chrono::milliseconds(1), cb_called);
- *  @endcode
- *
- * The lifetime of the TimerHandle controls the lifetime of the software timer.
- * If the handle leaves scope, the timer will be automatically unregistered.
- *
- * Template parameters simply match those in the original TimerManager declaration, since
- * TimerHandle is a class member.
- */
-template<const size_t TMaxTimers, typename TLock, typename TTimeUnit, typename TTimeoutCallback,
-		 typename TTimerDevice>
-class TimerManager<TMaxTimers, TLock, TTimeUnit, TTimeoutCallback, TTimerDevice>::TimerHandle
-{
-	friend class TimerManager<TMaxTimers, TLock, TTimeUnit, TTimeoutCallback, TTimerDevice>;
-
-  public:
-	/// Default constructor which creates an invalid object
-	TimerHandle() noexcept : mgr_(nullptr) {}
-
-	/// Destroying the TimerHandle also deletes it from the TimerManager's timer allocation queue
-	~TimerHandle() noexcept
-	{
-		destroy();
-	}
-
-	/// @brief Move Constructor
-	TimerHandle(TimerHandle&& rhs) noexcept : mgr_(rhs.mgr_), handle_(rhs.handle_)
-	{
-		rhs.mgr_ = nullptr;
-		rhs.handle_ = mgr_->timer_list_.end();
-	}
-
-	/// @brief Move assignment operator
-	TimerHandle& operator=(TimerHandle&& rhs) noexcept
-	{
-		std::swap(mgr_, rhs.mgr_);
-		std::swap(handle_, rhs.handle_);
-		rhs.destroy();
-
-		return *this;
-	}
-
-	/// Delete the copy constructor
-	TimerHandle(const TimerHandle&) = delete;
-
-	/// Delete the copy assignment operator
-	const TimerHandle& operator=(const TimerHandle&) = delete;
-
-	/** Check if the TimerHandle is valid.
-	 *
-	 * @returns true if the TimerHandle is valid, false otherwise
-	 */
-	bool valid() const noexcept
-	{
-		return (mgr_ != nullptr && handle_ != mgr_->timer_list_.end());
-	}
-
-	/** Operator bool checks validity.
-	 *
-	 * Operator bool() is used to check that a TimerHandle is valid.
-	 *
-	 * @returns true if the TimerHandle is valid, false otherwise
-	 */
-	operator bool() const noexcept
-	{
-		return valid();
-	}
-
-	/** Destroy the TimerHandle
-	 *
-	 * If the TimerHandle is invalid (i.e. already destroyed), the request will be
-	 * ignored.
-	 */
-	void destroy() noexcept
-	{
-		if(valid())
-		{
-			mgr_->deleteTimer(handle_);
-			handle_ = mgr_->timer_list_.end();
-		}
-	}
-
-	/** Cancel a software timer
-	 *
-	 * Request cancellation for a software timer. The cancellation request is best-effort,
-	 * and the timer may expire before the request is completed.
-	 *
-	 * @pre The TimerHandle is valid
-	 * @post The timer is cancelled, or has expired before cancellation was carried out.
-	 *
-	 * @returns True if the timer was cancelled, false if the timer expired before cancellation.
-	 */
-	bool cancel() noexcept
-	{
-		assert(valid());
-		return mgr_->cancel(handle_);
-	}
-
-	/** Configure a one-shot delay
-	 *
-	 * Configure the software timer to perform a one-shot asynchronous delay. When the timer
-	 *expires, the callback will be called. The timer will be removed from the scheduled queue.
-	 *
-	 * @pre The TimerHandle is valid.
-	 * @post The periodic delay is scheduled.
-	 *
-	 * The following template parameters should be automatically deduced by the compiler:
-	 *
-	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
-	 *uint64_t)
-	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
-	 *
-	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
-	 *	For example:
-	 *	@code
-	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
-	 *	@endcode
-	 * @param[in] func Function object that will be registered as the software timer callback.
-	 */
-	template<typename TRep, typename TPeriod>
-	void asyncDelay(const std::chrono::duration<TRep, TPeriod>& delay,
-					const TTimeoutCallback& func) noexcept
-	{
-		assert(valid());
-		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
-
-		mgr_->schedule(handle_, convertedDelay, func, embvm::timer::config::oneshot);
-	}
-
-	/** Configure a one-shot delay
-	 *
-	 * Configure the software timer to perform a one-shot asynchronous delay. When the timer
-	 *expires, the callback will be called. The timer will be removed from the scheduled queue.
-	 *
-	 * @pre The TimerHandle is valid.
-	 * @post The periodic delay is scheduled.
-	 *
-	 * The following template parameters should be automatically deduced by the compiler:
-	 *
-	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
-	 *uint64_t)
-	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
-	 *
-	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
-	 *	For example:
-	 *	@code
-	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
-	 *	@endcode
-	 * @param[in] func R-value function object that will be registered as the software timer
-	 *callback.
-	 */
-	template<typename TRep, typename TPeriod>
-	void asyncDelay(const std::chrono::duration<TRep, TPeriod>& delay,
-					TTimeoutCallback&& func) noexcept
-	{
-		assert(valid());
-		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
-
-		mgr_->schedule(handle_, convertedDelay, std::move(func), embvm::timer::config::oneshot);
-	}
-
-	/** Configure a periodic delay
-	 *
-	 * Configure the software timer to perform a periodic delay. When the timer expires, the
-	 *callback will be called adn the timer will be automatically re-added to the scheduled timer
-	 *queue.
-	 *
-	 * @pre The TimerHandle is valid.
-	 * @post The periodic delay is scheduled.
-	 *
-	 * The following template parameters should be automatically deduced by the compiler:
-	 *
-	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
-	 *uint64_t)
-	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
-	 *
-	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
-	 *	For example:
-	 *	@code
-	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
-	 *	@endcode
-	 * @param[in] func Function object that will be registered as the software timer callback.
-	 */
-	template<typename TRep, typename TPeriod>
-	void periodicDelay(const std::chrono::duration<TRep, TPeriod>& delay,
-					   const TTimeoutCallback& func) noexcept
-	{
-		assert(valid());
-		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
-
-		mgr_->schedule(handle_, convertedDelay, func, embvm::timer::config::periodic);
-	}
-
-	/** Configure a periodic delay
-	 *
-	 * Configure the software timer to perform a periodic delay. When the timer expires, the
-	 *callback will be called adn the timer will be automatically re-added to the scheduled timer
-	 *queue.
-	 *
-	 * @pre The TimerHandle is valid.
-	 * @post The periodic delay is scheduled.
-	 *
-	 * The following template parameters should be automatically deduced by the compiler:
-	 *
-	 * @tparam TRep Underlying storage type (representation) for the time units (e.g., uint32_t,
-	 *uint64_t)
-	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::nano)
-	 *
-	 * @param[in] delay std::chrono::duration representing the periodic timeout value delta.
-	 *	For example:
-	 *	@code
-	 *	std::chrono::duration<uint64_t, std::nano> delay = std::chrono::nanoseconds(1000);
-	 *	@endcode
-	 * @param[in] func R-value function object that will be registered as the software timer
-	 *callback.
-	 */
-	template<typename TRep, typename TPeriod>
-	void periodicDelay(const std::chrono::duration<TRep, TPeriod>& delay,
-					   TTimeoutCallback&& func) noexcept
-	{
-		assert(valid());
-		auto convertedDelay = std::chrono::duration_cast<TTimeUnit>(delay);
-
-		mgr_->schedule(handle_, convertedDelay, std::move(func), embvm::timer::config::periodic);
-	}
-
-  private:
-	/// Private constructor, used by TimerManager::allocate() to create new TimerHandle instances
-	explicit TimerHandle(TimerManager* mgr) noexcept : mgr_(mgr) {}
-
-  private:
-	/// @brief The owning TimerManager
-	TimerManager* mgr_;
-
-	/// @brief The handle for the delayInfo structure which corresponds with this timer
-	TQueueHandle handle_;
+	/// Monotonic time which scheduled deadlines are compared against.
+	TimeRep_t now_ = 0;
 };
 
 } // namespace embvm
@@ -2,10 +2,16 @@
 // SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
 
 #include "timer_manager.hpp"
+#include "timing_wheel_timer_manager.hpp"
+#include <algorithm>
 #include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
 #include <nop_lock/nop_lock.hpp>
 #include <simulator/timer.hpp>
+#include <simulator/virtual_timer.hpp>
 
 #pragma mark - Helpers -
 
@@ -24,6 +30,68 @@ static void cb_called_count()
 	count_++;
 }
 
+/// Timer whose count only changes when the test expires it, for deterministic scheduling tests.
+class ManualTimer final : public embvm::timer::Timer
+{
+  public:
+	void registerCallback(const embvm::timer::cb_t& cb) noexcept final
+	{
+		cb_ = cb;
+	}
+
+	void registerCallback(embvm::timer::cb_t&& cb) noexcept final
+	{
+		cb_ = std::move(cb);
+	}
+
+	[[nodiscard]] embvm::timer::timer_period_t count() const noexcept final
+	{
+		return elapsed_;
+	}
+
+	/// Advance the count without expiring the timer.
+	void advance(embvm::timer::timer_period_t t) noexcept
+	{
+		elapsed_ += t;
+	}
+
+	/// Run the timer to the end of its period and invoke the callback.
+	void expire() noexcept
+	{
+		elapsed_ = period_;
+
+		if(cb_)
+		{
+			cb_();
+		}
+	}
+
+  private:
+	void start_() noexcept final
+	{
+		elapsed_ = embvm::timer::timer_period_t(0);
+	}
+
+	void stop_() noexcept final {}
+
+	embvm::timer::cb_t cb_{nullptr};
+	embvm::timer::timer_period_t elapsed_{0};
+};
+
+template<const size_t TMaxTimers = 0>
+using ManualTimerManager = embvm::TimerManager<TMaxTimers, embutil::nop_lock,
+											   embvm::timer::timer_period_t,
+											   stdext::inplace_function<void()>, ManualTimer>;
+
+using VirtualTimerManager =
+	embvm::TimerManager<0, embutil::nop_lock, embvm::timer::timer_period_t,
+						stdext::inplace_function<void()>, VirtualTimer>;
+
+template<const size_t TMaxTimers = 0>
+using ManualWheelTimerManager =
+	embvm::TimingWheelTimerManager<TMaxTimers, embutil::nop_lock, embvm::timer::timer_period_t,
+								   stdext::inplace_function<void()>, ManualTimer, 2, 3>;
+
 #pragma mark - Test Cases -
 
 TEST_CASE("Create Timer Manager", "[core/platform/timer_mgr]")
@@ -213,3 +281,456 @@ TEST_CASE("Static Timer Handler Scheduling Tests", "[core/platform/timer_mgr]")
 		CHECK(2 <= count_);
 	}
 }
+
+TEST_CASE("Timers expire in deadline order", "[core/platform/timer_mgr]")
+{
+	ManualTimer timer;
+	ManualTimerManager<> tm(timer);
+	std::vector<int> order;
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+	auto h3 = tm.allocate();
+	auto h4 = tm.allocate();
+
+	h.asyncDelay(std::chrono::microseconds(30), [&] { order.push_back(3); });
+	h2.asyncDelay(std::chrono::microseconds(10), [&] { order.push_back(1); });
+	h3.asyncDelay(std::chrono::microseconds(20), [&] { order.push_back(2); });
+	h4.asyncDelay(std::chrono::microseconds(15), [&] { order.push_back(4); });
+
+	CHECK(std::chrono::microseconds(10) == timer.period());
+
+	// Cancelling a timer in the middle of the heap keeps the remaining order intact
+	CHECK(true == h4.cancel());
+	CHECK(false == h4.cancel());
+
+	timer.expire();
+	CHECK(std::chrono::microseconds(10) == timer.period());
+	timer.expire();
+	CHECK(std::chrono::microseconds(10) == timer.period());
+	timer.expire();
+
+	CHECK(std::vector<int>{1, 2, 3} == order);
+
+	// A cancelled timer can be scheduled again
+	h4.asyncDelay(std::chrono::microseconds(5), [&] { order.push_back(4); });
+	timer.expire();
+
+	CHECK(std::vector<int>{1, 2, 3, 4} == order);
+}
+
+TEST_CASE("Next expiration reports the time until the timer interrupt",
+		  "[core/platform/timer_mgr]")
+{
+	ManualTimer timer;
+	ManualTimerManager<> tm(timer);
+
+	CHECK(false == tm.nextExpiration().has_value());
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+	h.asyncDelay(std::chrono::microseconds(100), cb_called);
+	h2.asyncDelay(std::chrono::microseconds(40), cb_called);
+
+	CHECK(std::chrono::microseconds(40) == tm.nextExpiration());
+
+	// Time elapsed on the running hardware timer is accounted for
+	timer.advance(std::chrono::microseconds(15));
+	CHECK(std::chrono::microseconds(25) == tm.nextExpiration());
+
+	// A timer which is already due reports zero
+	timer.advance(std::chrono::microseconds(30));
+	CHECK(std::chrono::microseconds(0) == tm.nextExpiration());
+
+	timer.expire();
+	CHECK(std::chrono::microseconds(60) == tm.nextExpiration());
+
+	h.cancel();
+	CHECK(false == tm.nextExpiration().has_value());
+}
+
+TEST_CASE("Cancelling the front timer after the hardware overshoots restarts immediately",
+		  "[core/platform/timer_mgr]")
+{
+	ManualTimer timer;
+	ManualTimerManager<> tm(timer);
+	called_ = false;
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+	h.asyncDelay(std::chrono::microseconds(10), cb_called_count);
+	h2.asyncDelay(std::chrono::microseconds(20), cb_called);
+
+	// The interrupt is pending, and the hardware count has run past both deadlines
+	timer.advance(std::chrono::microseconds(50));
+	CHECK(true == h.cancel());
+
+	// The next timer is already due, so the hardware must not be armed for a wrapped delay
+	CHECK(std::chrono::microseconds(0) == timer.period());
+
+	timer.expire();
+	CHECK(true == called_);
+}
+
+TEST_CASE("Periodic timers are rescheduled from their deadline", "[core/platform/timer_mgr]")
+{
+	ManualTimer timer;
+	ManualTimerManager<10> tm(timer);
+	unsigned fast = 0;
+	unsigned slow = 0;
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+
+	h.periodicDelay(std::chrono::microseconds(10), [&] { fast++; });
+	h2.periodicDelay(std::chrono::microseconds(25), [&] { slow++; });
+
+	// 10, 20, 25, 30, 40, 50 (both)
+	for(int i = 0; i < 6; i++)
+	{
+		timer.expire();
+	}
+
+	CHECK(5 == fast);
+	CHECK(2 == slow);
+	CHECK(std::chrono::microseconds(10) == timer.period());
+}
+
+TEST_CASE("Rescheduling and cancelling keeps timers in deadline order",
+		  "[core/platform/timer_mgr]")
+{
+	constexpr size_t timer_count = 32;
+	ManualTimer timer;
+	ManualTimerManager<timer_count> tm(timer);
+	std::vector<ManualTimerManager<timer_count>::TimerHandle> handles;
+	std::vector<uint64_t> deadlines(timer_count, 0);
+	std::vector<uint64_t> fired;
+	uint32_t seed = 1;
+
+	auto next_random = [&seed]() {
+		seed = (seed * 1103515245U) + 12345U;
+		return (seed >> 16U) & 0x7FFFU;
+	};
+
+	for(size_t i = 0; i < timer_count; i++)
+	{
+		handles.push_back(tm.allocate());
+	}
+
+	// Schedule, reschedule (kick), and cancel timers in random positions of the heap
+	for(int op = 0; op < 500; op++)
+	{
+		auto i = next_random() % timer_count;
+
+		if(next_random() % 4 == 0)
+		{
+			handles[i].cancel();
+			deadlines[i] = 0;
+		}
+		else
+		{
+			auto delay = 1 + (next_random() % 1000);
+			deadlines[i] = delay;
+			handles[i].asyncDelay(std::chrono::microseconds(delay),
+								  [&, i] { fired.push_back(deadlines[i]); });
+		}
+	}
+
+	auto expected = static_cast<size_t>(
+		std::count_if(deadlines.begin(), deadlines.end(), [](uint64_t d) { return d > 0; }));
+
+	for(size_t i = 0; i < expected; i++)
+	{
+		timer.expire();
+	}
+
+	CHECK(expected == fired.size());
+	CHECK(true == std::is_sorted(fired.begin(), fired.end()));
+}
+
+TEST_CASE("Timers with overlapping tolerance windows share an interrupt",
+		  "[core/platform/timer_mgr]")
+{
+	ManualTimer timer;
+	ManualTimerManager<> tm(timer);
+	unsigned interrupts = 0;
+	std::vector<std::pair<int, unsigned>> fired;
+
+	auto record = [&](int id) { return [&, id] { fired.emplace_back(id, interrupts); }; };
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+	auto h3 = tm.allocate();
+	auto h4 = tm.allocate();
+
+	SECTION("Exact timers each take an interrupt")
+	{
+		h.asyncDelay(std::chrono::microseconds(100), record(1));
+		h2.asyncDelay(std::chrono::microseconds(105), record(2));
+		h3.asyncDelay(std::chrono::microseconds(110), record(3));
+
+		while(timer.started() && interrupts < 10)
+		{
+			interrupts++;
+			timer.expire();
+		}
+
+		CHECK(std::vector<std::pair<int, unsigned>>{{1, 1}, {2, 2}, {3, 3}} == fired);
+	}
+
+	SECTION("Overlapping windows are expired together")
+	{
+		// Windows: [100, 110], [105, 115], [110, 121], [300, 330]
+		h.asyncDelay(std::chrono::microseconds(100), record(1), modm::Tolerance::TenPercent);
+		h2.asyncDelay(std::chrono::microseconds(105), record(2), modm::Tolerance::TenPercent);
+		h3.asyncDelay(std::chrono::microseconds(110), record(3), modm::Tolerance::TenPercent);
+		h4.asyncDelay(std::chrono::microseconds(300), record(4), modm::Tolerance::TenPercent);
+
+		CHECK(std::chrono::microseconds(110) == timer.period());
+
+		while(timer.started() && interrupts < 10)
+		{
+			interrupts++;
+			timer.expire();
+		}
+
+		CHECK(std::vector<std::pair<int, unsigned>>{{1, 1}, {2, 1}, {3, 1}, {4, 2}} == fired);
+		CHECK(std::chrono::microseconds(220) == timer.period());
+	}
+
+	SECTION("Periodic timers with slack do not drift")
+	{
+		unsigned fast = 0;
+		unsigned slow = 0;
+
+		h.periodicDelay(
+			std::chrono::microseconds(100), [&] { fast++; }, modm::Tolerance::TwentyPercent);
+		h2.periodicDelay(
+			std::chrono::microseconds(110), [&] { slow++; }, modm::Tolerance::TwentyPercent);
+
+		// Every deadline is a multiple of the period, so each timer fires once per period even
+		// though it may run up to 20% late
+		uint64_t now = 0;
+		while(now < 10000)
+		{
+			now += timer.period().count();
+			interrupts++;
+			timer.expire();
+		}
+
+		CHECK(now / 100 >= fast);
+		CHECK((now - 20) / 100 <= fast);
+		CHECK(now / 110 >= slow);
+		CHECK((now - 22) / 110 <= slow);
+
+		// Fewer interrupts than callbacks
+		CHECK(interrupts < fast + slow);
+	}
+}
+
+TEST_CASE("Timer manager runs on virtual time", "[core/platform/timer_mgr]")
+{
+	VirtualClock clock;
+	VirtualTimer timer(clock);
+	VirtualTimerManager tm(timer);
+	unsigned heartbeats = 0;
+	bool on_time = true;
+	VirtualClock::duration_t timeout_at{0};
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+
+	h.periodicDelay(std::chrono::seconds(1), [&] {
+		heartbeats++;
+		on_time = on_time && (clock.now() == std::chrono::seconds(heartbeats));
+	});
+	h2.asyncDelay(std::chrono::minutes(90), [&] { timeout_at = clock.now(); });
+
+	// Two simulated hours
+	clock.advance(std::chrono::hours(2));
+
+	CHECK(7200 == heartbeats);
+	CHECK(true == on_time);
+	CHECK(std::chrono::minutes(90) == timeout_at);
+	CHECK(std::chrono::seconds(1) == tm.nextExpiration());
+}
+
+TEST_CASE("Timing wheel timer manager with simulator timer", "[core/platform/timer_mgr/wheel]")
+{
+	SimulatorTimer timer;
+	embvm::TimingWheelTimerManager<0, std::mutex> tm(timer, std::chrono::milliseconds(1));
+
+	count_ = 0;
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+
+	h.asyncDelay(std::chrono::milliseconds(2), cb_called_count);
+	h2.asyncDelay(std::chrono::milliseconds(500), cb_called_count);
+	CHECK(true == h2.cancel());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	CHECK(1 == count_);
+	CHECK(0 == tm.scheduled_count());
+}
+
+TEST_CASE("Timing wheel timers expire on their tick", "[core/platform/timer_mgr/wheel]")
+{
+	// A 4-slot, 3-level wheel has a range of 64 ticks, so every level and the parking slot are
+	// exercised
+	ManualTimer timer;
+	ManualWheelTimerManager<10> tm(timer, std::chrono::microseconds(10));
+	std::vector<std::pair<int, unsigned>> fired;
+	unsigned ticks = 0;
+
+	auto record = [&](int id) { return [&, id] { fired.emplace_back(id, ticks); }; };
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+	auto h3 = tm.allocate();
+	auto h4 = tm.allocate();
+	auto h5 = tm.allocate();
+	auto h6 = tm.allocate();
+
+	h.asyncDelay(std::chrono::microseconds(30), record(1));
+	h2.asyncDelay(std::chrono::microseconds(25), record(2));
+	h3.asyncDelay(std::chrono::microseconds(170), record(3));
+	h4.asyncDelay(std::chrono::microseconds(1000), record(4));
+	h5.periodicDelay(std::chrono::microseconds(200), record(5));
+	h6.asyncDelay(std::chrono::microseconds(400), record(6));
+
+	CHECK(std::chrono::microseconds(10) == timer.period());
+	CHECK(true == timer.started());
+	CHECK(6 == tm.scheduled_count());
+
+	CHECK(true == h6.cancel());
+	CHECK(false == h6.cancel());
+
+	while(timer.started() && ticks < 200)
+	{
+		ticks++;
+		timer.expire();
+
+		if(ticks == 50)
+		{
+			h5.cancel();
+		}
+	}
+
+	CHECK(std::vector<std::pair<int, unsigned>>{{2, 3}, {1, 3}, {3, 17}, {5, 20}, {5, 40},
+												 {4, 100}} == fired);
+
+	// The hardware timer stops once no timers are scheduled
+	CHECK(false == timer.started());
+	CHECK(0 == tm.scheduled_count());
+}
+
+TEST_CASE("Timing wheel counts the partial tick toward the delay",
+		  "[core/platform/timer_mgr/wheel]")
+{
+	ManualTimer timer;
+	embvm::TimingWheelTimerManager<0, embutil::nop_lock, embvm::timer::timer_period_t,
+								   stdext::inplace_function<void()>, ManualTimer>
+		tm(timer, std::chrono::microseconds(10));
+	unsigned ticks = 0;
+	unsigned fired_at = 0;
+
+	auto h = tm.allocate();
+	auto h2 = tm.allocate();
+
+	h.asyncDelay(std::chrono::microseconds(100), [] {});
+
+	// Move into the second tick, 5us into the period
+	ticks++;
+	timer.expire();
+	timer.advance(std::chrono::microseconds(5));
+
+	// 10us from now is 15us from the start of the current tick, so it needs two ticks
+	h2.asyncDelay(std::chrono::microseconds(10), [&] { fired_at = ticks; });
+
+	for(int i = 0; i < 3; i++)
+	{
+		ticks++;
+		timer.expire();
+	}
+
+	CHECK(3 == fired_at);
+}
+
+TEST_CASE("Timer manager scaling benchmark", "[core/platform/timer_mgr][!benchmark]")
+{
+	// Measures the cost of scheduling, cancelling, and expiring a timer while N others are pending
+	for(size_t n : {16, 128, 1024})
+	{
+		ManualTimer timer;
+		ManualTimerManager<> tm(timer);
+		std::vector<ManualTimerManager<>::TimerHandle> handles;
+
+		for(size_t i = 0; i < n; i++)
+		{
+			handles.push_back(tm.allocate());
+			handles.back().asyncDelay(std::chrono::seconds(1) + std::chrono::microseconds(i),
+									  [] {});
+		}
+
+		auto h = tm.allocate();
+		h.periodicDelay(std::chrono::microseconds(1), [] {});
+
+		BENCHMARK("Expire periodic timer, " + std::to_string(n) + " pending")
+		{
+			timer.expire();
+		};
+
+		auto h2 = tm.allocate();
+
+		BENCHMARK("Schedule and cancel timer, " + std::to_string(n) + " pending")
+		{
+			h2.asyncDelay(std::chrono::milliseconds(500), [] {});
+			return h2.cancel();
+		};
+
+		// A watchdog-style timer which is pushed back before it expires
+		h2.asyncDelay(std::chrono::milliseconds(500), [] {});
+		unsigned kick = 0;
+
+		BENCHMARK("Reschedule timer, " + std::to_string(n) + " pending")
+		{
+			h2.asyncDelay(std::chrono::milliseconds(500 + (kick++ % 1000)), [] {});
+		};
+	}
+}
+
+TEST_CASE("Timing wheel scaling benchmark", "[core/platform/timer_mgr/wheel][!benchmark]")
+{
+	for(size_t n : {16, 128, 1024})
+	{
+		ManualTimer timer;
+		embvm::TimingWheelTimerManager<0, embutil::nop_lock, embvm::timer::timer_period_t,
+									   stdext::inplace_function<void()>, ManualTimer>
+			tm(timer, std::chrono::microseconds(1));
+		std::vector<decltype(tm)::TimerHandle> handles;
+
+		for(size_t i = 0; i < n; i++)
+		{
+			handles.push_back(tm.allocate());
+			handles.back().asyncDelay(std::chrono::seconds(1) + std::chrono::microseconds(i),
+									  [] {});
+		}
+
+		auto h = tm.allocate();
+		h.periodicDelay(std::chrono::microseconds(1), [] {});
+
+		BENCHMARK("Wheel tick with periodic timer, " + std::to_string(n) + " pending")
+		{
+			timer.expire();
+		};
+
+		auto h2 = tm.allocate();
+
+		BENCHMARK("Wheel schedule and cancel timer, " + std::to_string(n) + " pending")
+		{
+			h2.asyncDelay(std::chrono::milliseconds(500), [] {});
+			return h2.cancel();
+		};
+	}
+}
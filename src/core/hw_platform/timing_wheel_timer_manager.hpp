@@ -0,0 +1,517 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef TIMING_WHEEL_TIMER_MANAGER_HPP_
+#define TIMING_WHEEL_TIMER_MANAGER_HPP_
+
+#include "timer_handle.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <driver/timer.hpp>
+#include <etl/list.h>
+#include <inplace_function/inplace_function.hpp>
+#include <list>
+#include <nop_lock/nop_lock.hpp>
+#include <utility>
+
+namespace embvm
+{
+/** Timer Manager based on a hierarchical timing wheel
+ *
+ * The TimingWheelTimerManager takes a hardware timer and uses it to produce a number of
+ * software timers, like embvm::TimerManager. It is intended for systems with many timers that
+ * are usually cancelled before they expire, such as protocol retransmits and idle timeouts.
+ *
+ * Time is divided into ticks of a fixed duration. Scheduled timers are stored in a hierarchy of
+ * TWheelLevels wheels, each with 2^TWheelBits slots. Level 0 slots hold timers which expire in
+ * a single tick, and each slot at level n covers 2^(TWheelBits * n) ticks. When the level 0
+ * wheel wraps, the next slot of the level above is cascaded into the finer wheels.
+ *
+ * - Scheduling and cancelling a timer are O(1)
+ * - Each tick expires the timers in one level 0 slot, with an occasional cascade
+ * - Timers expire after at least the requested delay, and at most one tick later
+ *
+ * The hardware timer runs periodically at the tick rate while any timer is scheduled, and is
+ * stopped when the last timer expires or is cancelled.
+ *
+ * Delays longer than 2^(TWheelBits * TWheelLevels) ticks are supported. The timer is parked in
+ * the last slot of the highest wheel and re-inserted until it is due.
+ *
+ * @code
+ * SimulatorTimer timer;
+ * embvm::TimingWheelTimerManager<> tm(timer, std::chrono::milliseconds(1));
+ *
+ * auto h = tm.allocate();
+ * h.asyncDelay(std::chrono::milliseconds(200), retransmit);
+ * h.cancel();
+ * @endcode
+ *
+ * Timer callbacks are invoked with the manager's lock held, so they must not call back into the
+ * manager. Use a dispatcher to run callbacks in another context.
+ *
+ * @tparam TMaxTimers The maximum number of software timers that can be created.
+ *	Size 0 indicates dynamic memory will be used. All other sizes will enable
+ *	static memory allocation.
+ * @tparam TLock The type of lock interface to use. Default is embutil::nop_lock, which disables
+ *	locking.
+ * @tparam TTimeUnit The time-keeping units for delays and the tick duration.
+ * @tparam TTimeoutCallback The storage type for the callback function.
+ * @tparam TTimerDevice The type of timer device that this class will manage.
+ * @tparam TWheelBits Each wheel has 2^TWheelBits slots.
+ * @tparam TWheelLevels The number of wheels. Each level adds TWheelBits bits of range, and
+ *	2^TWheelBits slot pointers of memory.
+ *
+ * @ingroup FrameworkHwPlatform
+ */
+template<const size_t TMaxTimers = 0, typename TLock = embutil::nop_lock,
+		 typename TTimeUnit = embvm::timer::timer_period_t,
+		 typename TTimeoutCallback = stdext::inplace_function<void()>,
+		 typename TTimerDevice = embvm::timer::Timer, const size_t TWheelBits = 6,
+		 const size_t TWheelLevels = 4>
+class TimingWheelTimerManager
+{
+	static_assert(TWheelBits > 0 && TWheelLevels > 0, "Timing wheel must have at least one slot");
+	static_assert(TWheelBits * TWheelLevels < 64, "Timing wheel range exceeds the tick counter");
+
+  public:
+	/// @brief Consumers interact with the software timer through the TimerHandle class
+	using TimerHandle = SoftwareTimerHandle<TimingWheelTimerManager>;
+
+	/// @brief The function prototype for the Dispatcher.
+	using DispatcherFunc = stdext::inplace_function<void(const TTimeoutCallback&)>;
+
+  private:
+	/// @brief The time-keeping units, used by TimerHandle
+	using TimeUnit_t = TTimeUnit;
+
+	/// @brief The callback storage type, used by TimerHandle
+	using TimeoutCallback_t = TTimeoutCallback;
+
+	/// The timer handle can call private TimingWheelTimerManager functions
+	friend class SoftwareTimerHandle<TimingWheelTimerManager>;
+
+	/// @brief Tick counter type
+	using Tick_t = uint64_t;
+
+	static constexpr size_t SLOT_COUNT = size_t(1) << TWheelBits;
+	static constexpr Tick_t SLOT_MASK = SLOT_COUNT - 1;
+	static constexpr Tick_t MAX_TICKS = Tick_t(1) << (TWheelBits * TWheelLevels);
+
+	/** Timer Delay Information
+	 *
+	 * Each timer is a node in the intrusive list of the wheel slot which holds it, so it can be
+	 * removed without searching.
+	 */
+	struct delayInfo
+	{
+		/// @brief The requested timer configuration
+		embvm::timer::config config = embvm::timer::config::oneshot;
+
+		/// @brief The tick on which the timer expires
+		Tick_t expires = 0;
+
+		/// @brief The period in ticks, used by periodic timers
+		Tick_t period = 0;
+
+		/// @brief The timer callback function.
+		TTimeoutCallback cb{};
+
+		/// @brief Indicates whether the timer is currently scheduled
+		bool wait_in_progress = false;
+
+		/// @brief Next timer in the same slot
+		delayInfo* next = nullptr;
+
+		/// @brief Previous timer in the same slot
+		delayInfo* prev = nullptr;
+
+		/// @brief The head of the slot list which holds this timer
+		delayInfo** slot = nullptr;
+	};
+
+	/// @brief Storage for allocated timers, which keeps iterators valid
+	using TTimerQueueType = typename std::conditional<(TMaxTimers == 0), std::list<delayInfo>,
+													  etl::list<delayInfo, TMaxTimers>>::type;
+
+	/// @brief Convenience alias for the queue handle type.
+	using TQueueHandle = typename TTimerQueueType::iterator;
+
+  public:
+	/** Create a TimingWheelTimerManager without a dispatcher.
+	 *
+	 * Timer callbacks are called directly by the manager.
+	 *
+	 * @param timer The timer hardware instance which the manager will manage.
+	 * @param tick The duration of a wheel tick, which is the timer resolution.
+	 */
+	explicit TimingWheelTimerManager(TTimerDevice& timer, TTimeUnit tick) noexcept
+		: dispatcher_(std::bind(&TimingWheelTimerManager::TimerManagerDispatch, this,
+								std::placeholders::_1)),
+		  timer_hw_(timer), tick_(tick)
+	{
+		assert(tick_.count() > 0);
+		timer_hw_.registerCallback(
+			std::bind(&TimingWheelTimerManager::TimerInterruptHandler, this));
+		timer.config(embvm::timer::config::periodic);
+	}
+
+	/** Create a TimingWheelTimerManager with a dispatcher.
+	 *
+	 * When a timer expires, the manager forwards the callback to the dispatcher, rather than
+	 * executing the callback directly.
+	 *
+	 * @param timer The timer hardware instance which the manager will manage.
+	 * @param tick The duration of a wheel tick, which is the timer resolution.
+	 * @param dispatcher Specifies a function which will dispatch all timer callbacks.
+	 */
+	explicit TimingWheelTimerManager(TTimerDevice& timer, TTimeUnit tick,
+									 const DispatcherFunc& dispatcher) noexcept
+		: dispatcher_(dispatcher), timer_hw_(timer), tick_(tick)
+	{
+		assert(tick_.count() > 0);
+		timer_hw_.registerCallback(
+			std::bind(&TimingWheelTimerManager::TimerInterruptHandler, this));
+		timer.config(embvm::timer::config::periodic);
+	}
+
+	/** Destroy the TimingWheelTimerManager
+	 *
+	 * On destruction, the manager stops the underlying timer hardware and unregisters
+	 * the manager's timer interrupt callback.
+	 */
+	~TimingWheelTimerManager() noexcept
+	{
+		wheel_lock_.lock();
+		timer_hw_.stop();
+		timer_hw_.registerCallback(nullptr);
+		wheel_lock_.unlock();
+	}
+
+	/// Deleted copy constructor
+	TimingWheelTimerManager(const TimingWheelTimerManager&) = delete;
+
+	/// Deleted copy assignment operator
+	const TimingWheelTimerManager& operator=(const TimingWheelTimerManager&) = delete;
+
+	/// Deleted move constructor
+	TimingWheelTimerManager(TimingWheelTimerManager&&) = delete;
+
+	/// Deleted move assignment operator
+	TimingWheelTimerManager& operator=(TimingWheelTimerManager&&) = delete;
+
+	/** Allocate a new software timer
+	 *
+	 * @returns A handle to the allocated software timer. The TimerHandle's lifetime controls the
+	 *	timer's lifetime - once the TimerHandle leaves scope, the timer will be automatically
+	 *	unregistered.
+	 */
+	TimerHandle allocate() noexcept
+	{
+		TimerHandle handle(this);
+
+		if constexpr(TMaxTimers > 0) // NOLINT
+		{
+			assert(timer_list_.size() < timer_list_.max_size());
+		}
+
+		timer_list_lock_.lock(); // NOLINT
+		timer_list_.push_back(delayInfo());
+		timer_list_lock_.unlock();
+
+		// We emplaced our element at the back, so decrement 1 from end() to get the iterator
+		auto h = timer_list_.end();
+		handle.handle_ = --h;
+
+		return handle;
+	}
+
+	/// Return the duration of a wheel tick
+	[[nodiscard]] auto tick() const noexcept -> TTimeUnit
+	{
+		return tick_;
+	}
+
+	/// Return the number of timers which are currently scheduled
+	[[nodiscard]] auto scheduled_count() const noexcept -> size_t
+	{
+		return scheduled_;
+	}
+
+  private:
+	/// Default dispatch function, which executes the callback directly.
+	void TimerManagerDispatch(const TTimeoutCallback& op) noexcept
+	{
+		op();
+	}
+
+	/** Timer interrupt handler, called once per tick.
+	 *
+	 * Note that this must work with an interrupt bottom-half handler because locking
+	 * calls are used here. It cannot be called directly in an ISR context!
+	 */
+	void TimerInterruptHandler() noexcept
+	{
+		wheel_lock_.lock();
+
+		processTick();
+
+		if(scheduled_ == 0 && ticking_)
+		{
+			timer_hw_.stop();
+			ticking_ = false;
+		}
+
+		wheel_lock_.unlock();
+	}
+
+	/// Get the number of whole ticks in a delay, rounded up.
+	auto toTicks(TTimeUnit delay) const noexcept -> Tick_t
+	{
+		auto t = static_cast<Tick_t>(tick_.count());
+
+		return (static_cast<Tick_t>(delay.count()) + t - 1) / t;
+	}
+
+	/** Schedule a timer.
+	 *
+	 * The tolerance is not used: expirations are already batched by tick.
+	 */
+	template<typename TCallback>
+	void schedule(TQueueHandle handle, TTimeUnit delay, TCallback&& func,
+				  embvm::timer::config config, [[maybe_unused]] uint16_t tolerance) noexcept
+	{
+		auto& timer = *handle;
+
+		wheel_lock_.lock();
+
+		// The next tick is processed (tick - elapsed) from now, so the partial tick counts
+		// toward the delay
+		TTimeUnit elapsed{0};
+		if(ticking_)
+		{
+			elapsed = std::chrono::duration_cast<TTimeUnit>(timer_hw_.count()) % tick_.count();
+		}
+
+		if(timer.wait_in_progress)
+		{
+			unlink(timer);
+		}
+		else
+		{
+			timer.wait_in_progress = true;
+			scheduled_++;
+		}
+
+		timer.config = config;
+		timer.cb = std::forward<TCallback>(func);
+		timer.period = std::max<Tick_t>(toTicks(delay), 1);
+		timer.expires = next_tick_ + std::max<Tick_t>(toTicks(delay + elapsed), 1) - 1;
+		insert(timer);
+
+		if(!ticking_)
+		{
+			timer_hw_.restart(std::chrono::duration_cast<embvm::timer::timer_period_t>(tick_));
+			ticking_ = true;
+		}
+
+		wheel_lock_.unlock();
+	}
+
+	/// Returns false if no wait was scheduled or if the callback was already called
+	/// Returns true if cancelled successfully
+	bool cancel(TQueueHandle handle) noexcept
+	{
+		bool canceled = false;
+
+		wheel_lock_.lock();
+
+		if(handle->wait_in_progress)
+		{
+			// The hardware timer stops on the next tick if no timers remain
+			unlink(*handle);
+			handle->wait_in_progress = false;
+			scheduled_--;
+			canceled = true;
+		}
+
+		wheel_lock_.unlock();
+
+		return canceled;
+	}
+
+	void deleteTimer(TQueueHandle handle) noexcept
+	{
+		cancel(handle);
+
+		timer_list_lock_.lock();
+		timer_list_.erase(handle);
+		timer_list_lock_.unlock();
+	}
+
+	/** Add a timer to the wheel which covers its expiration tick.
+	 *
+	 * @pre wheel_lock_ is held, and timer.expires >= next_tick_.
+	 */
+	void insert(delayInfo& timer) noexcept
+	{
+		auto expires = timer.expires;
+		auto delta = expires - next_tick_;
+
+		if(delta >= MAX_TICKS)
+		{
+			// Park the timer at the end of the wheel range, and re-insert it when it is reached
+			delta = MAX_TICKS - 1;
+			expires = next_tick_ + delta;
+		}
+
+		size_t level = 0;
+		while(level + 1 < TWheelLevels && delta >= (Tick_t(1) << (TWheelBits * (level + 1))))
+		{
+			level++;
+		}
+
+		auto slot = (expires >> (TWheelBits * level)) & SLOT_MASK;
+		auto& head = wheels_[level][slot];
+
+		timer.slot = &head;
+		timer.prev = nullptr;
+		timer.next = head;
+
+		if(head)
+		{
+			head->prev = &timer;
+		}
+
+		head = &timer;
+	}
+
+	/// Remove a timer from its slot list. @pre wheel_lock_ is held.
+	void unlink(delayInfo& timer) noexcept
+	{
+		if(timer.prev)
+		{
+			timer.prev->next = timer.next;
+		}
+		else
+		{
+			*timer.slot = timer.next;
+		}
+
+		if(timer.next)
+		{
+			timer.next->prev = timer.prev;
+		}
+
+		timer.next = nullptr;
+		timer.prev = nullptr;
+		timer.slot = nullptr;
+	}
+
+	/// Detach the list of timers in a slot. @pre wheel_lock_ is held.
+	static auto takeSlot(delayInfo*& head) noexcept -> delayInfo*
+	{
+		auto* list = head;
+		head = nullptr;
+
+		return list;
+	}
+
+	/// Re-insert every timer in a slot into the finer wheels. @pre wheel_lock_ is held.
+	void cascade(size_t level, size_t slot) noexcept
+	{
+		auto* timer = takeSlot(wheels_[level][slot]);
+
+		while(timer)
+		{
+			auto* next = timer->next;
+			insert(*timer);
+			timer = next;
+		}
+	}
+
+	/** Process the next tick: cascade the higher wheels if needed, then expire the timers in
+	 * the current level 0 slot.
+	 *
+	 * @pre wheel_lock_ is held.
+	 */
+	void processTick() noexcept
+	{
+		auto index = static_cast<size_t>(next_tick_ & SLOT_MASK);
+
+		// When a wheel wraps, the next slot of the wheel above is due
+		for(size_t level = 1; index == 0 && level < TWheelLevels; level++)
+		{
+			auto slot = static_cast<size_t>((next_tick_ >> (TWheelBits * level)) & SLOT_MASK);
+			cascade(level, slot);
+
+			if(slot != 0)
+			{
+				break;
+			}
+		}
+
+		auto* timer = takeSlot(wheels_[0][index]);
+
+		while(timer)
+		{
+			auto* next = timer->next;
+
+			if(timer->expires > next_tick_)
+			{
+				// Parked beyond the wheel range
+				insert(*timer);
+			}
+			else
+			{
+				auto callback = timer->cb;
+
+				// Oneshot timers are removed - periodic timers are rescheduled
+				if(timer->config == embvm::timer::config::periodic)
+				{
+					timer->expires += timer->period;
+					insert(*timer);
+				}
+				else
+				{
+					timer->next = nullptr;
+					timer->prev = nullptr;
+					timer->slot = nullptr;
+					timer->wait_in_progress = false;
+					scheduled_--;
+				}
+
+				if(callback)
+				{
+					dispatcher_(callback);
+				}
+			}
+
+			timer = next;
+		}
+
+		next_tick_++;
+	}
+
+  private:
+	const DispatcherFunc dispatcher_;
+	TTimerQueueType timer_list_{};
+	/// Slot lists for each wheel level.
+	std::array<std::array<delayInfo*, SLOT_COUNT>, TWheelLevels> wheels_{};
+	TLock wheel_lock_;
+	TLock timer_list_lock_;
+	TTimerDevice& timer_hw_;
+	/// The duration of a tick.
+	const TTimeUnit tick_;
+	/// The next tick to be processed.
+	Tick_t next_tick_ = 0;
+	/// The number of scheduled timers.
+	size_t scheduled_ = 0;
+	/// Indicates that the hardware timer is running.
+	bool ticking_ = false;
+};
+
+} // namespace embvm
+
+#endif // TIMING_WHEEL_TIMER_MANAGER_HPP_
@@ -0,0 +1,433 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef VIRTUAL_PLATFORM_DEFERRED_DISPATCHER_HPP_
+#define VIRTUAL_PLATFORM_DEFERRED_DISPATCHER_HPP_
+
+#include "virtual_platform_dispatch.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <etl/vector.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace embvm
+{
+/** Add delayed dispatching to the VirtualPlatform through inheritance.
+ *
+ * PlatformDeferredDispatcher extends PlatformDispatcher with dispatch_after() and dispatch_at().
+ * Deferred operations are stored in a single deadline heap, and the service uses only one
+ * software timer from the provided TimerManager, regardless of how many operations are waiting.
+ * When the earliest deadline expires, all expired operations are forwarded to the platform
+ * dispatch queue, and the timer is re-armed for the next deadline.
+ *
+ * Example declaration:
+ *	```
+ *	using PlatformDispatchQueue = embutil::DynamicDispatchQueue<>;
+ *	using PlatformTimerManager = embvm::TimerManager<8, std::mutex>;
+ *
+ *	class SimulatorPlatform : public VirtualPlatform, public
+ *		PlatformDeferredDispatcher<PlatformDispatchQueue, PlatformTimerManager, 32>
+ *	{...}
+ *	```
+ *
+ * The timer is allocated by initDeferredDispatch(), which should be called once the
+ * TimerManager has been constructed (e.g., during the platform's init_() function):
+ *	```
+ *	initDeferredDispatch(timer_manager_);
+ *	dispatch_after(std::chrono::milliseconds(100), retry_transfer);
+ *	```
+ *
+ * Timer callbacks only enqueue a service operation on the dispatch queue; the deadline heap is
+ * processed and the timer is re-armed from a dispatch thread. This means the TimerManager is
+ * never called from within its own callback. The dispatch queue must have at least one thread.
+ *
+ * A timer callback can still be pending after the timer is cancelled (e.g., when the
+ * TimerManager forwards callbacks to its own queue), and a service operation can still be
+ * waiting in the dispatch queue. Both reach the dispatcher through callback state which outlives
+ * it, so a late callback or service operation after destruction has no effect. In dynamic memory
+ * mode the state is reference counted. In static memory mode the state is taken from a static
+ * pool of TMaxDispatchers entries, and is reused once its dispatcher is destroyed.
+ *
+ * @note Deferred operations can be requested from multiple threads, so the TimerManager must be
+ *	declared with a functional lock type (e.g., `embvm::TimerManager<8, std::mutex>`).
+ *
+ * @tparam TDispatchQueue The type declaration for the underlying dispatch queue.
+ * @tparam TTimerManager The embvm::TimerManager type which provides the software timer.
+ * @tparam TMaxDeferred The maximum number of deferred operations which can be waiting.
+ *	Size 0 indicates dynamic memory will be used. All other sizes will enable static memory
+ *	allocation.
+ * @tparam TClock The clock used to evaluate deadlines. The clock must satisfy the requirements
+ *	of a std::chrono clock (e.g., provide a static now() function and a time_point type).
+ * @tparam TLock Type to use for the lock which protects the deadline heap.
+ * @tparam TMaxDispatchers The maximum number of dispatchers of this type which can exist at the
+ *	same time in static memory mode. Unused in dynamic memory mode.
+ *
+ * @ingroup FrameworkPlatform
+ */
+template<class TDispatchQueue, class TTimerManager, const size_t TMaxDeferred = 0,
+		 typename TClock = std::chrono::steady_clock, typename TLock = std::mutex,
+		 const size_t TMaxDispatchers = 1>
+class PlatformDeferredDispatcher : public PlatformDispatcher<TDispatchQueue>
+{
+	using TFunc = typename TDispatchQueue::DispatchFunc_t;
+	using TTimePoint = typename TClock::time_point;
+	using TTimerHandle = typename TTimerManager::TimerHandle;
+
+	/** State shared with timer callbacks and service operations.
+	 *
+	 * Callbacks and service operations hold a CallbackRef rather than a pointer to the
+	 * dispatcher, so one which runs after the dispatcher is destroyed finds no owner and returns.
+	 */
+	struct CallbackState
+	{
+		/// Held while the owner is checked, and while the owner is cleared.
+		TLock lock;
+
+		/// The dispatcher, or nullptr once it is being destroyed.
+		PlatformDeferredDispatcher* owner = nullptr;
+
+		/// Incremented each time a static state is released, so a late callback from a previous
+		/// owner does not reach the next one.
+		uint32_t generation = 0;
+
+		/// Number of service operations which are running.
+		size_t running = 0;
+
+		/// Indicates that a dispatcher has claimed the state (static memory mode only).
+		bool in_use = false;
+	};
+
+	/// Reference to the callback state.
+	/// In dynamic memory mode the reference keeps the state alive. In static memory mode the
+	/// state has static storage, and the generation identifies the owner.
+	struct CallbackRef
+	{
+		/// The referenced state.
+		typename std::conditional<(TMaxDeferred == 0), std::shared_ptr<CallbackState>,
+								  CallbackState*>::type state;
+
+		/// The generation of the state when the reference was created.
+		uint32_t generation;
+	};
+
+	/// An operation which is waiting for its deadline.
+	struct DeferredOp
+	{
+		/// The time at which the operation should be dispatched.
+		TTimePoint deadline;
+
+		/// The operation to dispatch.
+		TFunc op;
+	};
+
+	/** Comparator for the deadline heap
+	 *
+	 * The earliest deadline is kept at the front of the heap.
+	 */
+	struct deadlineCompare
+	{
+		bool operator()(const DeferredOp& lhs, const DeferredOp& rhs) noexcept
+		{
+			return rhs.deadline < lhs.deadline;
+		}
+	};
+
+	/** Type definition for the deadline heap.
+	 *
+	 * The type changes depending on whether static or dynamic memory allocation is being used
+	 * (dynamic memory is indicated by `TMaxDeferred == 0`)
+	 */
+	using TDeadlineQueueType =
+		typename std::conditional<(TMaxDeferred == 0), std::vector<DeferredOp>,
+								  etl::vector<DeferredOp, TMaxDeferred>>::type;
+
+  public:
+	using PlatformDispatcher<TDispatchQueue>::PlatformDispatcher;
+
+	/** Destroy the deferred dispatcher.
+	 *
+	 * Operations which are still waiting for their deadline are discarded. The destructor waits
+	 * for a service operation which is already running, but not for one which is still queued.
+	 */
+	~PlatformDeferredDispatcher() noexcept
+	{
+		auto& state = *callback_ref_.state;
+
+		// Waits for a running timer callback; callbacks which run later find no owner
+		std::unique_lock<TLock> state_lock(state.lock);
+		state.owner = nullptr;
+		state_lock.unlock();
+
+		std::unique_lock<TLock> arm_lock(arm_lock_);
+		quit_ = true;
+
+		if(timer_.valid())
+		{
+			timer_.cancel();
+			timer_.destroy();
+		}
+
+		arm_lock.unlock();
+
+		// A running service operation still uses the dispatcher. It does not wait on this
+		// thread, so the wait is bounded by the time it takes to service the deadline heap.
+		state_lock.lock();
+		while(state.running > 0)
+		{
+			state_lock.unlock();
+			std::this_thread::yield();
+			state_lock.lock();
+		}
+
+		if constexpr(TMaxDeferred > 0)
+		{
+			state.generation++;
+			state.in_use = false;
+		}
+	}
+
+	/** Allocate the software timer used for deferred operations.
+	 *
+	 * @pre initDeferredDispatch() has not been called before.
+	 * @param tm The TimerManager which will provide the software timer.
+	 */
+	void initDeferredDispatch(TTimerManager& tm) noexcept
+	{
+		assert(!timer_.valid() && "initDeferredDispatch() can only be called once");
+		timer_ = tm.allocate();
+	}
+
+	/** Dispatch an operation after a delay.
+	 *
+	 * The operation is forwarded to the dispatch queue once the delay has elapsed. The delay is a
+	 * minimum: the operation may run later if the dispatch queue is busy.
+	 *
+	 * @pre initDeferredDispatch() has been called.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units.
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::milli).
+	 *
+	 * @param delay The minimum time to wait before the operation is dispatched.
+	 * @param op The function object containing the operation that will be dispatched.
+	 */
+	template<typename TRep, typename TPeriod>
+	void dispatch_after(const std::chrono::duration<TRep, TPeriod>& delay,
+						const TFunc& op) noexcept
+	{
+		enqueue(TClock::now() + std::chrono::ceil<typename TClock::duration>(delay), op);
+	}
+
+	/// @overload void dispatch_after(const std::chrono::duration<TRep, TPeriod>&, const TFunc&)
+	template<typename TRep, typename TPeriod>
+	void dispatch_after(const std::chrono::duration<TRep, TPeriod>& delay, TFunc&& op) noexcept
+	{
+		enqueue(TClock::now() + std::chrono::ceil<typename TClock::duration>(delay),
+				std::move(op));
+	}
+
+	/** Dispatch an operation at a specific time.
+	 *
+	 * If the deadline has already passed, the operation is dispatched as soon as possible.
+	 *
+	 * @pre initDeferredDispatch() has been called.
+	 *
+	 * @tparam TDuration The duration type of the time point. Deduced by the compiler.
+	 * @param deadline The earliest time at which the operation is dispatched.
+	 * @param op The function object containing the operation that will be dispatched.
+	 */
+	template<typename TDuration>
+	void dispatch_at(const std::chrono::time_point<TClock, TDuration>& deadline,
+					 const TFunc& op) noexcept
+	{
+		enqueue(std::chrono::ceil<typename TClock::duration>(deadline), op);
+	}
+
+	/// @overload void dispatch_at(const std::chrono::time_point<TClock, TDuration>&, const TFunc&)
+	template<typename TDuration>
+	void dispatch_at(const std::chrono::time_point<TClock, TDuration>& deadline,
+					 TFunc&& op) noexcept
+	{
+		enqueue(std::chrono::ceil<typename TClock::duration>(deadline), std::move(op));
+	}
+
+	/** Get the number of operations waiting for their deadline.
+	 *
+	 * @returns the number of deferred operations which have not been dispatched yet.
+	 */
+	size_t deferred_count() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		return deadlines_.size();
+	}
+
+  private:
+	/// Add an operation to the deadline heap, re-arming the timer if it is the new earliest.
+	template<typename TOp>
+	void enqueue(TTimePoint deadline, TOp&& op) noexcept
+	{
+		assert(timer_.valid() && "initDeferredDispatch() must be called first");
+
+		std::unique_lock<TLock> lock(lock_);
+
+		if constexpr(TMaxDeferred > 0)
+		{
+			assert(deadlines_.size() < deadlines_.capacity() &&
+				   "Max deferred operations reached - increase TMaxDeferred\n");
+		}
+
+		deadlines_.push_back(DeferredOp{deadline, std::forward<TOp>(op)});
+		std::push_heap(deadlines_.begin(), deadlines_.end(), deadlineCompare());
+		bool earliest = !(deadlines_.front().deadline < deadline);
+
+		lock.unlock();
+
+		if(earliest)
+		{
+			arm();
+		}
+	}
+
+	/// Start the timer for the earliest deadline in the heap.
+	void arm() noexcept
+	{
+		// Serializes timer requests so an older deadline cannot overwrite a newer one
+		std::lock_guard<TLock> arm_lock(arm_lock_);
+
+		std::unique_lock<TLock> lock(lock_);
+		if(quit_ || deadlines_.empty())
+		{
+			return;
+		}
+
+		auto next = deadlines_.front().deadline;
+		lock.unlock();
+
+		auto delay = std::max(next - TClock::now(), TClock::duration::zero());
+		timer_.asyncDelay(delay, [ref = callback_ref_]() noexcept {
+			std::lock_guard<TLock> lock(ref.state->lock);
+			if(owned(ref))
+			{
+				ref.state->owner->timeout();
+			}
+		});
+	}
+
+	/** Timer callback: process the deadline heap from the dispatch queue.
+	 *
+	 * @pre The callback state lock is held, so the destructor cannot complete during this call.
+	 */
+	void timeout() noexcept
+	{
+		if(!quit_)
+		{
+			this->dispatch([ref = callback_ref_]() noexcept { run_service(ref); });
+		}
+	}
+
+	/// Call service() on the dispatcher which owns the callback state, if it still exists.
+	static void run_service(const CallbackRef& ref) noexcept
+	{
+		std::unique_lock<TLock> lock(ref.state->lock);
+		if(!owned(ref))
+		{
+			return;
+		}
+
+		// The destructor waits for running service operations
+		auto* owner = ref.state->owner;
+		ref.state->running++;
+		lock.unlock();
+
+		owner->service();
+
+		lock.lock();
+		ref.state->running--;
+	}
+
+	/// Check whether the dispatcher which created a reference still owns the state.
+	/// @pre The callback state lock is held.
+	static bool owned(const CallbackRef& ref) noexcept
+	{
+		return ref.state->owner && ref.state->generation == ref.generation;
+	}
+
+	/// Claim a callback state for this dispatcher.
+	CallbackRef acquire_callback_state() noexcept
+	{
+		if constexpr(TMaxDeferred == 0)
+		{
+			auto state = std::make_shared<CallbackState>();
+			state->owner = this;
+			return CallbackRef{std::move(state), 0};
+		}
+		else
+		{
+			for(auto& state : callback_states_)
+			{
+				std::lock_guard<TLock> lock(state.lock);
+				if(!state.in_use)
+				{
+					state.in_use = true;
+					state.owner = this;
+					return CallbackRef{&state, state.generation};
+				}
+			}
+
+			assert(0 && "Max deferred dispatchers reached - increase TMaxDispatchers\n");
+			return CallbackRef{nullptr, 0};
+		}
+	}
+
+	/// Dispatch every expired operation and re-arm the timer for the next deadline.
+	void service() noexcept
+	{
+		if(!quit_)
+		{
+			std::unique_lock<TLock> lock(lock_);
+			auto now = TClock::now();
+
+			while(!deadlines_.empty() && !(now < deadlines_.front().deadline))
+			{
+				std::pop_heap(deadlines_.begin(), deadlines_.end(), deadlineCompare());
+				this->dispatch(std::move(deadlines_.back().op));
+				deadlines_.pop_back();
+			}
+
+			lock.unlock();
+
+			arm();
+		}
+	}
+
+  private:
+	/// Lock which protects the deadline heap.
+	TLock lock_;
+	/// Lock which serializes requests to the software timer.
+	TLock arm_lock_;
+	/// Operations waiting for their deadline, sorted as a heap.
+	TDeadlineQueueType deadlines_{};
+	/// State shared with timer callbacks and service operations, which may outlive the
+	/// dispatcher.
+	CallbackRef callback_ref_ = acquire_callback_state();
+	/// The single software timer shared by all deferred operations.
+	TTimerHandle timer_{};
+	/// Flag used to signal that the dispatcher is being destroyed.
+	std::atomic<bool> quit_ = false;
+	/// Callback states for static memory mode. Unused in dynamic memory mode.
+	static inline std::array<CallbackState, (TMaxDeferred == 0) ? 0 : TMaxDispatchers>
+		callback_states_{};
+};
+
+} // namespace embvm
+
+#endif // VIRTUAL_PLATFORM_DEFERRED_DISPATCHER_HPP_
@@ -0,0 +1,219 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "virtual_platform_deferred_dispatch.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <hw_platform/timer_manager.hpp>
+#include <mutex>
+#include <simulator/timer.hpp>
+#include <thread>
+#include <vector>
+
+using namespace embdrv;
+
+#pragma mark - Helpers -
+
+using TestTimerManager = embvm::TimerManager<4, std::mutex>;
+using TestDeferredDispatcher =
+	embvm::PlatformDeferredDispatcher<embutil::DynamicDispatchQueue<>, TestTimerManager, 8>;
+
+static std::atomic<unsigned> count_ = 0;
+
+static void cb_count()
+{
+	count_++;
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create deferred dispatcher", "[core/platform/deferred_dispatch]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	TestDeferredDispatcher d("Deferred Queue", 1);
+
+	d.initDeferredDispatch(tm);
+
+	CHECK(0 == d.deferred_count());
+}
+
+TEST_CASE("dispatch_after runs after the delay", "[core/platform/deferred_dispatch]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	TestDeferredDispatcher d("Deferred Queue", 1);
+	d.initDeferredDispatch(tm);
+	count_ = 0;
+
+	d.dispatch_after(std::chrono::milliseconds(20), cb_count);
+
+	CHECK(1 == d.deferred_count());
+	CHECK(0 == count_);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+	CHECK(1 == count_);
+	CHECK(0 == d.deferred_count());
+}
+
+TEST_CASE("dispatch_at with a past deadline runs immediately", "[core/platform/deferred_dispatch]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	TestDeferredDispatcher d("Deferred Queue", 1);
+	d.initDeferredDispatch(tm);
+	count_ = 0;
+
+	d.dispatch_at(std::chrono::steady_clock::now() - std::chrono::milliseconds(1), cb_count);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	CHECK(1 == count_);
+}
+
+TEST_CASE("Deferred operations share one timer and run in deadline order",
+		  "[core/platform/deferred_dispatch]")
+{
+	std::vector<int> order;
+	std::mutex order_lock;
+	auto record = [&](int v) {
+		std::lock_guard<std::mutex> lock(order_lock);
+		order.push_back(v);
+	};
+
+	{
+		SimulatorTimer timer;
+		TestTimerManager tm(timer);
+		TestDeferredDispatcher d("Deferred Queue", 1);
+		d.initDeferredDispatch(tm);
+
+		// Re-arming the simulator timer takes time, so all deadlines use the same base
+		auto now = std::chrono::steady_clock::now();
+
+		// The TimerManager only has room for 4 timers, so this only works with a shared timer
+		d.dispatch_at(now + std::chrono::milliseconds(30), [&] { record(3); });
+		d.dispatch_at(now + std::chrono::milliseconds(10), [&] { record(1); });
+		d.dispatch_at(now + std::chrono::milliseconds(40), [&] { record(4); });
+		d.dispatch_at(now + std::chrono::milliseconds(20), [&] { record(2); });
+		d.dispatch_at(now + std::chrono::milliseconds(50), [&] { record(5); });
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+		CHECK(0 == d.deferred_count());
+	}
+
+	CHECK(std::vector<int>{1, 2, 3, 4, 5} == order);
+}
+
+TEST_CASE("Destroying deferred dispatcher discards waiting operations",
+		  "[core/platform/deferred_dispatch]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	count_ = 0;
+
+	{
+		TestDeferredDispatcher d("Deferred Queue", 1);
+		d.initDeferredDispatch(tm);
+		d.dispatch_after(std::chrono::milliseconds(20), cb_count);
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+	CHECK(0 == count_);
+}
+
+TEST_CASE("Timer callbacks queued by the TimerManager outlive the deferred dispatcher",
+		  "[core/platform/deferred_dispatch]")
+{
+	std::vector<stdext::inplace_function<void()>> pending;
+	std::mutex pending_lock;
+
+	SimulatorTimer timer;
+	TestTimerManager tm(timer, [&](const stdext::inplace_function<void()>& cb) {
+		std::lock_guard<std::mutex> lock(pending_lock);
+		pending.push_back(cb);
+	});
+	count_ = 0;
+
+	{
+		TestDeferredDispatcher d("Deferred Queue", 1);
+		d.initDeferredDispatch(tm);
+		d.dispatch_after(std::chrono::milliseconds(1), cb_count);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	// The timer expired, but its callback was still queued when the dispatcher was destroyed
+	std::lock_guard<std::mutex> lock(pending_lock);
+	REQUIRE(1 == pending.size());
+	pending.front()();
+
+	CHECK(0 == count_);
+}
+
+TEST_CASE("Late timer callbacks do not reach the next owner of a static callback state",
+		  "[core/platform/deferred_dispatch]")
+{
+	std::vector<stdext::inplace_function<void()>> pending;
+	std::mutex pending_lock;
+
+	SimulatorTimer timer;
+	TestTimerManager tm(timer, [&](const stdext::inplace_function<void()>& cb) {
+		std::lock_guard<std::mutex> lock(pending_lock);
+		pending.push_back(cb);
+	});
+	count_ = 0;
+
+	{
+		TestDeferredDispatcher d("Deferred Queue", 1);
+		d.initDeferredDispatch(tm);
+		d.dispatch_after(std::chrono::milliseconds(1), cb_count);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	// The new dispatcher reuses the callback state of the destroyed one
+	TestDeferredDispatcher d("Deferred Queue", 1);
+	d.initDeferredDispatch(tm);
+	d.dispatch_after(std::chrono::milliseconds(1), cb_count);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+	std::unique_lock<std::mutex> lock(pending_lock);
+	REQUIRE(2 == pending.size());
+	auto late = pending.front();
+	auto current = pending.back();
+	lock.unlock();
+
+	late();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	CHECK(0 == count_);
+	CHECK(1 == d.deferred_count());
+
+	current();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	CHECK(1 == count_);
+	CHECK(0 == d.deferred_count());
+}
+
+TEST_CASE("Destroying deferred dispatcher does not wait for a queued service operation",
+		  "[core/platform/deferred_dispatch]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	count_ = 0;
+
+	{
+		// Without worker threads, the service operation is never run
+		TestDeferredDispatcher d("Deferred Queue", 0);
+		d.initDeferredDispatch(tm);
+		d.dispatch_after(std::chrono::milliseconds(1), cb_count);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	CHECK(0 == count_);
+}
@@ -0,0 +1,172 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef VIRTUAL_PLATFORM_TICKLESS_IDLE_HPP_
+#define VIRTUAL_PLATFORM_TICKLESS_IDLE_HPP_
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace embvm
+{
+/** Add tickless idle support to the VirtualPlatform through inheritance.
+ *
+ * PlatformTicklessIdle lets the platform sleep until the next piece of work is due, instead of
+ * waking up periodically to check for work. When idle() is called, the service checks that the
+ * provided dispatch and interrupt queues are empty, queries the earliest pending deadline from
+ * the TimerManager, and calls the platform's idle_until_() hook with that deadline. If no timers
+ * are scheduled, the deadline is `TClock::time_point::max()`.
+ *
+ * Example declaration:
+ *	```
+ *	using PlatformTimerManager = embvm::TimerManager<8, std::mutex>;
+ *
+ *	class SimulatorPlatform : public VirtualPlatform, public
+ *		PlatformTicklessIdle<SimulatorPlatform, PlatformTimerManager>
+ *	{...}
+ *	```
+ *
+ * The TimerManager is provided by initTicklessIdle(), which should be called once the
+ * TimerManager has been constructed. The platform's idle loop then passes its queues to idle():
+ *	```
+ *	initTicklessIdle(timer_manager_);
+ *
+ *	while(true)
+ *	{
+ *		idle(dispatch_queue_, interrupt_queue_);
+ *	}
+ *	```
+ *
+ * The default idle_until_() implementation blocks the calling thread with a timed wait, which is
+ * how the simulator idles. Target platforms provide their own idle_until_() (e.g., to program a
+ * wakeup and enter a low-power mode), which hides the default implementation:
+ *	```
+ *	template<class TTimePoint>
+ *	void idle_until_(TTimePoint deadline) noexcept;
+ *	```
+ *
+ * Work which arrives from another context while the platform is idle must call wake(), which
+ * ends the wait early. A wake() which races with the empty-queue check is not lost: the next
+ * wait returns immediately. On targets where the new work is always signaled by an interrupt,
+ * the interrupt itself ends the low-power mode, and the platform can provide an empty wake_().
+ *
+ * @tparam TPlatform The derived CRTP class which defines the consumer's platform.
+ * @tparam TTimerManager The embvm::TimerManager type which provides the next deadline.
+ * @tparam TClock The clock used to express the idle deadline. The clock must satisfy the
+ *	requirements of a std::chrono clock (e.g., provide a static now() function and a time_point
+ *	type).
+ *
+ * @ingroup FrameworkPlatform
+ */
+template<typename TPlatform, class TTimerManager, typename TClock = std::chrono::steady_clock>
+class PlatformTicklessIdle
+{
+	using TTimePoint = typename TClock::time_point;
+
+  public:
+	/** Provide the TimerManager which is queried for the next deadline.
+	 *
+	 * @pre initTicklessIdle() has not been called before.
+	 * @param tm The TimerManager whose scheduled timers bound the idle period.
+	 */
+	void initTicklessIdle(TTimerManager& tm) noexcept
+	{
+		assert(timer_manager_ == nullptr && "initTicklessIdle() can only be called once");
+		timer_manager_ = &tm;
+	}
+
+	/** Idle the platform until the next timer deadline, if no work is pending.
+	 *
+	 * The platform does not idle if any of the queues contains work, or if a timer is already
+	 * due. In that case the caller should run the pending work and call idle() again.
+	 *
+	 * @pre initTicklessIdle() has been called.
+	 *
+	 * @tparam TQueues The queue types, which are deduced by the compiler. Each queue must provide
+	 *	a queue_size() function (e.g., embutil::DispatchQueue or embutil::InterruptQueue).
+	 * @param queues The dispatch and interrupt queues which must be empty before idling.
+	 * @returns true if the platform idled, false if work was pending.
+	 */
+	template<typename... TQueues>
+	bool idle(const TQueues&... queues) noexcept
+	{
+		assert(timer_manager_ && "initTicklessIdle() must be called first");
+
+		if(((queues.queue_size() > 0) || ...))
+		{
+			return false;
+		}
+
+		auto next = timer_manager_->nextExpiration();
+		auto deadline = TTimePoint::max();
+
+		if(next)
+		{
+			if(next->count() == 0)
+			{
+				return false;
+			}
+
+			deadline = TClock::now() + std::chrono::ceil<typename TClock::duration>(*next);
+		}
+
+		static_cast<TPlatform*>(this)->idle_until_(deadline);
+
+		return true;
+	}
+
+	/** End the current (or next) idle period early.
+	 *
+	 * Call wake() after queuing work from another thread, so the platform can process it.
+	 * This function is safe to call from any thread.
+	 */
+	void wake() noexcept
+	{
+		static_cast<TPlatform*>(this)->wake_();
+	}
+
+  protected:
+	/** Default idle hook: block the calling thread until the deadline or a wake() request.
+	 *
+	 * @param deadline The time at which the next timer expires.
+	 */
+	void idle_until_(TTimePoint deadline) noexcept
+	{
+		std::unique_lock<std::mutex> lock(wake_lock_);
+
+		if(deadline == TTimePoint::max())
+		{
+			wake_cv_.wait(lock, [this] { return wake_pending_; });
+		}
+		else
+		{
+			wake_cv_.wait_until(lock, deadline, [this] { return wake_pending_; });
+		}
+
+		wake_pending_ = false;
+	}
+
+	/// Default wake hook: end the wait in the default idle_until_() implementation.
+	void wake_() noexcept
+	{
+		std::lock_guard<std::mutex> lock(wake_lock_);
+		wake_pending_ = true;
+		wake_cv_.notify_one();
+	}
+
+  private:
+	/// The TimerManager which provides the next deadline.
+	TTimerManager* timer_manager_ = nullptr;
+	/// Lock which protects wake_pending_.
+	std::mutex wake_lock_;
+	/// Condition variable used by the default idle_until_() to wait for the deadline.
+	std::condition_variable wake_cv_;
+	/// Set by wake() and cleared when an idle period ends.
+	bool wake_pending_ = false;
+};
+
+} // namespace embvm
+
+#endif // VIRTUAL_PLATFORM_TICKLESS_IDLE_HPP_
@@ -0,0 +1,144 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "virtual_platform_tickless_idle.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <hw_platform/timer_manager.hpp>
+#include <mutex>
+#include <simulator/timer.hpp>
+#include <thread>
+
+using namespace embdrv;
+
+#pragma mark - Helpers -
+
+using TestTimerManager = embvm::TimerManager<4, std::mutex>;
+
+/// Queue stand-in which reports a fixed number of pending operations.
+struct TestQueue
+{
+	size_t queue_size() const noexcept
+	{
+		return pending;
+	}
+
+	size_t pending = 0;
+};
+
+/// Platform which uses the default (simulator) idle hook.
+class TestIdlePlatform : public embvm::PlatformTicklessIdle<TestIdlePlatform, TestTimerManager>
+{
+};
+
+/// Platform which records the requested deadline instead of sleeping.
+class RecordingIdlePlatform
+	: public embvm::PlatformTicklessIdle<RecordingIdlePlatform, TestTimerManager>
+{
+  public:
+	void idle_until_(std::chrono::steady_clock::time_point deadline) noexcept
+	{
+		deadline_ = deadline;
+		idle_count_++;
+	}
+
+	std::chrono::steady_clock::time_point deadline_{};
+	unsigned idle_count_ = 0;
+};
+
+static void cb_nop() {}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Tickless idle does not idle while work is pending", "[core/platform/tickless_idle]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	RecordingIdlePlatform p;
+	TestQueue dispatch_queue;
+	TestQueue interrupt_queue;
+	p.initTicklessIdle(tm);
+
+	interrupt_queue.pending = 1;
+	CHECK(false == p.idle(dispatch_queue, interrupt_queue));
+	CHECK(0 == p.idle_count_);
+
+	interrupt_queue.pending = 0;
+	CHECK(true == p.idle(dispatch_queue, interrupt_queue));
+	CHECK(1 == p.idle_count_);
+}
+
+TEST_CASE("Tickless idle sleeps until the next timer deadline", "[core/platform/tickless_idle]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	RecordingIdlePlatform p;
+	TestQueue dispatch_queue;
+	p.initTicklessIdle(tm);
+
+	SECTION("No timers scheduled")
+	{
+		CHECK(false == tm.nextExpiration().has_value());
+		CHECK(true == p.idle(dispatch_queue));
+		CHECK(std::chrono::steady_clock::time_point::max() == p.deadline_);
+	}
+
+	SECTION("Earliest timer bounds the idle period")
+	{
+		auto h = tm.allocate();
+		auto h2 = tm.allocate();
+		h.asyncDelay(std::chrono::milliseconds(500), cb_nop);
+		h2.asyncDelay(std::chrono::milliseconds(200), cb_nop);
+
+		auto start = std::chrono::steady_clock::now();
+		CHECK(true == p.idle(dispatch_queue));
+
+		CHECK(p.deadline_ > start + std::chrono::milliseconds(150));
+		CHECK(p.deadline_ <= start + std::chrono::milliseconds(205));
+
+		h.cancel();
+		h2.cancel();
+	}
+}
+
+TEST_CASE("Simulator idle hook waits for the deadline or a wake request",
+		  "[core/platform/tickless_idle]")
+{
+	SimulatorTimer timer;
+	TestTimerManager tm(timer);
+	TestIdlePlatform p;
+	TestQueue dispatch_queue;
+	p.initTicklessIdle(tm);
+
+	SECTION("Timer deadline ends the idle period")
+	{
+		auto h = tm.allocate();
+		h.asyncDelay(std::chrono::milliseconds(20), cb_nop);
+
+		auto start = std::chrono::steady_clock::now();
+		CHECK(true == p.idle(dispatch_queue));
+
+		CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(15));
+	}
+
+	SECTION("wake() ends an idle period with no timers")
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::thread waker([&p] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			p.wake();
+		});
+
+		CHECK(true == p.idle(dispatch_queue));
+		CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+		waker.join();
+	}
+
+	SECTION("wake() before idling is not lost")
+	{
+		p.wake();
+
+		CHECK(true == p.idle(dispatch_queue));
+	}
+}
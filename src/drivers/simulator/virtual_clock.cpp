@@ -0,0 +1,90 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "virtual_clock.hpp"
+#include "virtual_timer.hpp"
+#include <algorithm>
+
+using namespace embdrv;
+
+size_t VirtualClock::advanceTo(duration_t target) noexcept
+{
+	size_t count = 0;
+
+	// Callbacks can arm new timers, so the next timer is found again after each expiration
+	while(!armed_.empty() && armed_[next()].timer->deadline_ <= target)
+	{
+		expireNext();
+		count++;
+	}
+
+	now_ = std::max(now_, target);
+
+	return count;
+}
+
+bool VirtualClock::step() noexcept
+{
+	if(armed_.empty())
+	{
+		return false;
+	}
+
+	expireNext();
+
+	return true;
+}
+
+std::optional<VirtualClock::duration_t> VirtualClock::nextDeadline() const noexcept
+{
+	if(armed_.empty())
+	{
+		return std::nullopt;
+	}
+
+	return armed_[next()].timer->deadline_;
+}
+
+void VirtualClock::arm(VirtualTimer* timer) noexcept
+{
+	disarm(timer);
+	armed_.push_back(ArmedTimer{timer, sequence_++});
+}
+
+void VirtualClock::disarm(VirtualTimer* timer) noexcept
+{
+	armed_.erase(std::remove_if(armed_.begin(), armed_.end(),
+								[timer](const ArmedTimer& t) { return t.timer == timer; }),
+				 armed_.end());
+}
+
+size_t VirtualClock::next() const noexcept
+{
+	size_t index = 0;
+
+	for(size_t i = 1; i < armed_.size(); i++)
+	{
+		auto& candidate = armed_[i];
+		auto& best = armed_[index];
+
+		if(candidate.timer->deadline_ < best.timer->deadline_ ||
+		   (candidate.timer->deadline_ == best.timer->deadline_ &&
+			candidate.sequence < best.sequence))
+		{
+			index = i;
+		}
+	}
+
+	return index;
+}
+
+void VirtualClock::expireNext() noexcept
+{
+	auto index = next();
+	auto* timer = armed_[index].timer;
+
+	armed_.erase(armed_.begin() + static_cast<std::ptrdiff_t>(index));
+	now_ = std::max(now_, timer->deadline_);
+
+	timer->expire();
+}
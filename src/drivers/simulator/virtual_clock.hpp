@@ -0,0 +1,174 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef SIMULATOR_VIRTUAL_CLOCK_HPP_
+#define SIMULATOR_VIRTUAL_CLOCK_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <driver/timer.hpp>
+#include <optional>
+#include <vector>
+
+namespace embdrv
+{
+class VirtualTimer;
+
+/** Discrete-event virtual time source for simulator drivers.
+ *
+ * VirtualClock keeps a virtual time value which only changes when the clock is advanced.
+ * VirtualTimer and VirtualSystemClock drivers are bound to a VirtualClock instead of
+ * std::chrono::steady_clock. When the clock is advanced, armed timers expire in deadline order,
+ * and the virtual time is set to each timer's deadline before its callback is invoked. No real
+ * time passes, so a long simulated scenario runs as fast as the callbacks allow, and produces
+ * the same sequence of events on every run.
+ *
+ * @code
+ * embdrv::VirtualClock clock;
+ * embdrv::VirtualTimer timer(clock);
+ * embvm::TimerManager<0, embutil::nop_lock, embvm::timer::timer_period_t,
+ *	stdext::inplace_function<void()>, embdrv::VirtualTimer> tm(timer);
+ *
+ * auto h = tm.allocate();
+ * h.periodicDelay(std::chrono::seconds(1), heartbeat);
+ *
+ * clock.advance(std::chrono::hours(1)); // 3600 heartbeats, in milliseconds of real time
+ * @endcode
+ *
+ * Timers which expire at the same virtual time fire in the order in which they were armed.
+ *
+ * @note VirtualClock is not thread-safe. The clock must be advanced, and its timers started and
+ *	stopped, from a single thread. Timer callbacks run on the thread which advances the clock.
+ *
+ * @ingroup SimulatorDrivers
+ */
+class VirtualClock
+{
+  public:
+	/// The virtual time unit, which matches the resolution of the timer and clock drivers.
+	using duration_t = embvm::timer::timer_period_t;
+
+	/// Create a virtual clock which starts at time 0.
+	VirtualClock() noexcept = default;
+
+	/// Default destructor
+	~VirtualClock() noexcept = default;
+
+	/// Deleted copy constructor
+	VirtualClock(const VirtualClock&) = delete;
+
+	/// Deleted copy assignment operator
+	const VirtualClock& operator=(const VirtualClock&) = delete;
+
+	/// Deleted move constructor
+	VirtualClock(VirtualClock&&) = delete;
+
+	/// Deleted move assignment operator
+	VirtualClock& operator=(VirtualClock&&) = delete;
+
+	/** Get the current virtual time.
+	 *
+	 * @returns the virtual time elapsed since the clock was created.
+	 */
+	[[nodiscard]] duration_t now() const noexcept
+	{
+		return now_;
+	}
+
+	/** Advance the virtual time, expiring every timer which is due along the way.
+	 *
+	 * Timers armed by a callback are also expired if they fall within the interval.
+	 *
+	 * @param delta The amount of virtual time to advance.
+	 * @returns the number of timer expirations which occurred.
+	 */
+	size_t advance(duration_t delta) noexcept
+	{
+		return advanceTo(now_ + delta);
+	}
+
+	/** Advance the virtual time to a specific time.
+	 *
+	 * If the target time has already passed, only timers which are already due are expired.
+	 *
+	 * @param target The virtual time to advance to.
+	 * @returns the number of timer expirations which occurred.
+	 */
+	size_t advanceTo(duration_t target) noexcept;
+
+	/** Jump to the next timer deadline and expire that timer.
+	 *
+	 * @returns true if a timer expired, false if no timers are armed.
+	 */
+	bool step() noexcept;
+
+	/** Get the deadline of the next timer to expire.
+	 *
+	 * @returns the virtual time of the earliest deadline, or an empty optional if no timers are
+	 *	armed.
+	 */
+	[[nodiscard]] std::optional<duration_t> nextDeadline() const noexcept;
+
+	/** Get the number of armed timers.
+	 *
+	 * @returns the number of timers waiting to expire.
+	 */
+	[[nodiscard]] size_t armed() const noexcept
+	{
+		return armed_.size();
+	}
+
+  private:
+	/// VirtualTimer arms and disarms itself with the clock.
+	friend class VirtualTimer;
+
+	/// An armed timer, and the order in which it was armed.
+	struct ArmedTimer
+	{
+		/// The armed timer.
+		VirtualTimer* timer;
+
+		/// Breaks ties between timers with the same deadline.
+		uint64_t sequence;
+	};
+
+	/** Arm a timer.
+	 *
+	 * The timer's deadline must be set before it is armed.
+	 *
+	 * @param timer The timer to arm. A timer which is already armed is moved to the back of the
+	 *	firing order for its deadline.
+	 */
+	void arm(VirtualTimer* timer) noexcept;
+
+	/** Disarm a timer.
+	 *
+	 * @param timer The timer to disarm. Disarming a timer which is not armed has no effect.
+	 */
+	void disarm(VirtualTimer* timer) noexcept;
+
+	/** Find the next timer to expire.
+	 *
+	 * Virtual simulations only use a handful of hardware timers, so a linear search is used.
+	 *
+	 * @returns the index of the next timer in armed_. Only valid if armed_ is not empty.
+	 */
+	[[nodiscard]] size_t next() const noexcept;
+
+	/// Remove the next timer from the armed list, advance to its deadline, and expire it.
+	void expireNext() noexcept;
+
+  private:
+	/// The current virtual time.
+	duration_t now_{0};
+
+	/// Timers which are waiting to expire.
+	std::vector<ArmedTimer> armed_{};
+
+	/// Incremented each time a timer is armed.
+	uint64_t sequence_ = 0;
+};
+
+} // namespace embdrv
+
+#endif // SIMULATOR_VIRTUAL_CLOCK_HPP_
@@ -0,0 +1,8 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "virtual_system_clock.hpp"
+
+using namespace embdrv;
+
+VirtualSystemClock::~VirtualSystemClock() noexcept = default;
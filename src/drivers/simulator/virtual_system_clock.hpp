@@ -0,0 +1,71 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef SIMULATOR_VIRTUAL_SYSTEM_CLOCK_HPP_
+#define SIMULATOR_VIRTUAL_SYSTEM_CLOCK_HPP_
+
+#include "virtual_clock.hpp"
+#include <driver/system_clock.hpp>
+#include <ratio>
+
+namespace embdrv
+{
+/** Simulator system clock driver which runs on virtual time.
+ *
+ * VirtualSystemClock is a drop-in replacement for SimulatorSystemClock which reports the time of
+ * a VirtualClock. Instead of sleeping, spin() advances the virtual time, which expires any
+ * VirtualTimer that becomes due during the spin.
+ *
+ * @ingroup SimulatorDrivers
+ */
+class VirtualSystemClock final : public embvm::clk::SystemClock
+{
+  public:
+	/** Create a system clock which reports virtual time.
+	 *
+	 * @param clock The virtual clock which provides the time.
+	 */
+	explicit VirtualSystemClock(VirtualClock& clock) noexcept : clock_(clock)
+	{
+		static_assert(std::ratio_less_equal<VirtualClock::duration_t::period,
+											tick_duration_t::period>::value,
+					  "Clock frequency cannot support period specified by SystemClock base class");
+	}
+
+	/// Default destructor
+	~VirtualSystemClock() noexcept;
+
+	[[nodiscard]] embvm::clk::freq_hz_t::rep frequency() const noexcept final
+	{
+		return std::ratio_divide<std::ratio<1, 1>, VirtualClock::duration_t::period>::num;
+	}
+
+	[[nodiscard]] tick_duration_t::rep ticks() const noexcept final
+	{
+		return std::chrono::duration_cast<tick_duration_t>(clock_.now()).count();
+	}
+
+	void spin(spin_duration_t::rep count) noexcept final
+	{
+		clock_.advance(spin_duration_t{count});
+	}
+
+  protected:
+	void start_() noexcept final
+	{
+		// Empty passthrough for simulator - no need to start/stop anything
+	}
+
+	void stop_() noexcept final
+	{
+		// Empty passthrough for simulator - no need to start/stop anything
+	}
+
+  private:
+	/// The virtual clock which provides the time.
+	VirtualClock& clock_;
+};
+
+} // namespace embdrv
+
+#endif // SIMULATOR_VIRTUAL_SYSTEM_CLOCK_HPP_
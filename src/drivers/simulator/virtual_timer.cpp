@@ -0,0 +1,56 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "virtual_timer.hpp"
+#include <algorithm>
+
+using namespace embdrv;
+
+VirtualTimer::~VirtualTimer() noexcept
+{
+	stop();
+	clock_.disarm(this);
+}
+
+void VirtualTimer::start_() noexcept
+{
+	state_ = embvm::timer::state::armed;
+	period_start_ = clock_.now();
+	deadline_ = period_start_ + period_;
+	running_ = true;
+
+	clock_.arm(this);
+}
+
+void VirtualTimer::stop_() noexcept
+{
+	if(running_)
+	{
+		count_ = clock_.now() - period_start_;
+		running_ = false;
+	}
+
+	state_ = embvm::timer::state::stopped;
+
+	clock_.disarm(this);
+}
+
+void VirtualTimer::expire() noexcept
+{
+	state_ = embvm::timer::state::expired;
+
+	if(config_ == embvm::timer::config::periodic)
+	{
+		// A zero period would never let virtual time advance
+		period_start_ = deadline_;
+		deadline_ += std::max(period_, embvm::timer::timer_period_t(1));
+		clock_.arm(this);
+	}
+	else
+	{
+		count_ = period_;
+		running_ = false;
+	}
+
+	invokeCallback(cb_);
+}
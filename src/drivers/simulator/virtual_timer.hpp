@@ -0,0 +1,119 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef SIMULATOR_VIRTUAL_TIMER_HPP_
+#define SIMULATOR_VIRTUAL_TIMER_HPP_
+
+#include "virtual_clock.hpp"
+#include <driver/timer.hpp>
+
+// clang-format off
+#include <driver/hal_driver.hpp>// This has to be last b/c of an OS X include pollution
+// clang-format on
+
+namespace embdrv
+{
+/** Simulator timer driver which runs on virtual time.
+ *
+ * VirtualTimer is a drop-in replacement for SimulatorTimer which is driven by a VirtualClock
+ * instead of a timer thread. The timer expires when the clock is advanced past its deadline, and
+ * the callback is invoked on the thread which advances the clock.
+ *
+ * A periodic timer is re-armed from its previous deadline, so the period does not drift.
+ *
+ * @ingroup SimulatorDrivers
+ */
+class VirtualTimer final : public embvm::timer::Timer, public embvm::HALDriverBase
+{
+  public:
+	/** Create a virtual timer with default options.
+	 *
+	 * @param clock The virtual clock which drives the timer.
+	 */
+	explicit VirtualTimer(VirtualClock& clock) noexcept : clock_(clock)
+	{
+		period_ = embvm::timer::timer_period_t(0);
+		config_ = embvm::timer::config::oneshot;
+	}
+
+	/** Create a virtual timer and set configuration options
+	 *
+	 * @param clock The virtual clock which drives the timer.
+	 * @param period The desired timer period.
+	 * @param config The desired timer configuration (oneshot or periodic).
+	 */
+	explicit VirtualTimer(VirtualClock& clock, embvm::timer::timer_period_t period,
+						  embvm::timer::config config = embvm::timer::config::oneshot) noexcept
+		: clock_(clock)
+	{
+		period_ = period;
+		config_ = config;
+	}
+
+	/** Create a virtual timer and set configuration options and callback
+	 *
+	 * @param clock The virtual clock which drives the timer.
+	 * @param period The desired timer period.
+	 * @param cb The callback function to invoke when the timer expires.
+	 * @param config The desired timer configuration (oneshot or periodic).
+	 */
+	explicit VirtualTimer(VirtualClock& clock, embvm::timer::timer_period_t period,
+						  embvm::timer::cb_t cb,
+						  embvm::timer::config config = embvm::timer::config::oneshot) noexcept
+		: cb_(std::move(cb)), clock_(clock)
+	{
+		period_ = period;
+		config_ = config;
+	}
+
+	/// Destructor, which disarms the timer.
+	~VirtualTimer() noexcept override;
+
+	void registerCallback(const embvm::timer::cb_t& cb) noexcept final
+	{
+		cb_ = cb;
+	}
+
+	void registerCallback(embvm::timer::cb_t&& cb) noexcept final
+	{
+		cb_ = std::move(cb);
+	}
+
+	/** Read the current timer count.
+	 *
+	 * @returns the virtual time elapsed in the current period. Once the timer is stopped or a
+	 *	oneshot timer expires, the count holds its final value until the timer is started again.
+	 */
+	[[nodiscard]] embvm::timer::timer_period_t count() const noexcept final
+	{
+		return running_ ? clock_.now() - period_start_ : count_;
+	}
+
+	void enableInterrupts() noexcept final {}
+	void disableInterrupts() noexcept final {}
+
+  private:
+	/// The clock reads the deadline and expires the timer.
+	friend class VirtualClock;
+
+	void start_() noexcept final;
+	void stop_() noexcept final;
+
+	/// Called by the clock when the virtual time reaches the deadline.
+	void expire() noexcept;
+
+	embvm::timer::cb_t cb_{nullptr};
+	VirtualClock& clock_;
+	/// The virtual time at which the timer expires.
+	VirtualClock::duration_t deadline_{0};
+	/// The virtual time at which the current period began.
+	VirtualClock::duration_t period_start_{0};
+	/// The count reported while the timer is not running.
+	embvm::timer::timer_period_t count_{0};
+	/// Whether the timer is armed with the clock.
+	bool running_ = false;
+};
+
+} // namespace embdrv
+
+#endif // SIMULATOR_VIRTUAL_TIMER_HPP_
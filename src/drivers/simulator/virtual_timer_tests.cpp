@@ -0,0 +1,130 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <simulator/virtual_clock.hpp>
+#include <simulator/virtual_system_clock.hpp>
+#include <simulator/virtual_timer.hpp>
+#include <vector>
+
+using namespace embdrv;
+
+TEST_CASE("Virtual system clock", "[driver/simulator/virtual_clock]")
+{
+	VirtualClock clock;
+	VirtualSystemClock sys_clock(clock);
+
+	CHECK(1000000 == sys_clock.frequency());
+	CHECK(0 == sys_clock.ticks());
+
+	sys_clock.spin(100);
+
+	CHECK(100 == sys_clock.ticks());
+	CHECK(std::chrono::microseconds(100) == clock.now());
+}
+
+TEST_CASE("Virtual timers expire in deadline order", "[driver/simulator/virtual_timer]")
+{
+	VirtualClock clock;
+	std::vector<int> order;
+	std::vector<VirtualClock::duration_t> times;
+
+	VirtualTimer t1(clock, std::chrono::microseconds(30), [&] {
+		order.push_back(1);
+		times.push_back(clock.now());
+	});
+	VirtualTimer t2(clock, std::chrono::microseconds(10), [&] {
+		order.push_back(2);
+		times.push_back(clock.now());
+	});
+	VirtualTimer t3(clock, std::chrono::microseconds(20), [&] {
+		order.push_back(3);
+		times.push_back(clock.now());
+	});
+
+	t1.start();
+	t2.start();
+	t3.start();
+
+	CHECK(3 == clock.armed());
+	CHECK(std::chrono::microseconds(10) == clock.nextDeadline());
+
+	CHECK(2 == clock.advance(std::chrono::microseconds(25)));
+	CHECK(std::chrono::microseconds(25) == clock.now());
+	CHECK(std::chrono::microseconds(25) == t1.count());
+	CHECK(std::chrono::microseconds(20) == t3.count());
+
+	CHECK(1 == clock.advance(std::chrono::microseconds(100)));
+	CHECK(0 == clock.armed());
+	CHECK(false == clock.step());
+
+	// Callbacks see the virtual time of their own deadline
+	CHECK(std::vector<int>{2, 3, 1} == order);
+	CHECK(std::vector<VirtualClock::duration_t>{std::chrono::microseconds(10),
+												std::chrono::microseconds(20),
+												std::chrono::microseconds(30)} == times);
+}
+
+TEST_CASE("Virtual timers with the same deadline expire in start order",
+		  "[driver/simulator/virtual_timer]")
+{
+	VirtualClock clock;
+	std::vector<int> order;
+
+	VirtualTimer t1(clock, std::chrono::microseconds(10), [&] { order.push_back(1); });
+	VirtualTimer t2(clock, std::chrono::microseconds(10), [&] { order.push_back(2); });
+
+	t2.start();
+	t1.start();
+
+	CHECK(true == clock.step());
+	CHECK(std::chrono::microseconds(10) == clock.now());
+	CHECK(true == clock.step());
+	CHECK(std::vector<int>{2, 1} == order);
+}
+
+TEST_CASE("Stopped virtual timers do not expire", "[driver/simulator/virtual_timer]")
+{
+	VirtualClock clock;
+	unsigned count = 0;
+	VirtualTimer t(clock, std::chrono::microseconds(50), [&] { count++; });
+
+	t.start();
+	clock.advance(std::chrono::microseconds(20));
+	t.stop();
+
+	CHECK(embvm::timer::state::stopped == t.state());
+	CHECK(std::chrono::microseconds(20) == t.count());
+	CHECK(0 == clock.advance(std::chrono::microseconds(100)));
+	CHECK(0 == count);
+
+	// Restarting measures the period from the current virtual time
+	t.restart();
+	CHECK(0 == clock.advance(std::chrono::microseconds(49)));
+	CHECK(1 == clock.advance(std::chrono::microseconds(1)));
+	CHECK(embvm::timer::state::expired == t.state());
+	CHECK(1 == count);
+}
+
+TEST_CASE("Periodic virtual timer runs a long horizon without drift",
+		  "[driver/simulator/virtual_timer]")
+{
+	VirtualClock clock;
+	VirtualSystemClock sys_clock(clock);
+	unsigned count = 0;
+	VirtualTimer t(clock, std::chrono::milliseconds(10), [&] { count++; },
+				   embvm::timer::config::periodic);
+
+	t.start();
+
+	// One simulated hour
+	clock.advance(std::chrono::hours(1));
+	CHECK(360000 == count);
+	CHECK(std::chrono::hours(1) == clock.now());
+
+	// Spinning the system clock advances the same virtual time
+	sys_clock.spin(25000);
+	CHECK(360002 == count);
+	CHECK(std::chrono::milliseconds(5) == t.count());
+}
@@ -5,6 +5,9 @@
 #include <time.h> // We need time.h before os.hpp for Linux builds because of system header types...
 // clang-format on
 #include "os.hpp"
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
 #include <time/time.hpp>
 
 using namespace os::posix;
@@ -40,6 +43,69 @@ Mutex::~Mutex() noexcept
 	assert(r == 0);
 }
 
+#pragma mark - Thread Options -
+
+auto os::posix::apply_thread_options(const thread_options& options) noexcept -> int
+{
+	int result = 0;
+	auto record = [&result](int r) {
+		if(result == 0)
+		{
+			result = r;
+		}
+	};
+
+	if(!options.name.empty())
+	{
+		// Linux limits names to 16 bytes, including the terminator
+		char name[16] = {0};
+		options.name.copy(name, sizeof(name) - 1);
+
+#ifdef __APPLE__
+		record(pthread_setname_np(name));
+#else
+		record(pthread_setname_np(pthread_self(), name));
+#endif
+	}
+
+	if(options.cpu_mask)
+	{
+#ifdef __linux__
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+
+		for(unsigned cpu = 0; cpu < 64; cpu++)
+		{
+			if(options.cpu_mask & (uint64_t(1) << cpu))
+			{
+				CPU_SET(cpu, &cpus);
+			}
+		}
+
+		record(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus));
+#else
+		record(ENOTSUP);
+#endif
+	}
+
+	if(options.policy != sched_policy::inherit)
+	{
+		sched_param schedule{};
+		int policy = SCHED_OTHER;
+
+		if(options.policy != sched_policy::other)
+		{
+			policy = (options.policy == sched_policy::fifo) ? SCHED_FIFO : SCHED_RR;
+			schedule.sched_priority =
+				static_cast<int>(convert_to_pthread_priority(options.priority));
+		}
+
+		record(pthread_setschedparam(pthread_self(), policy, &schedule));
+	}
+
+	return result;
+}
+
 #pragma mark - this_thread implementations -
 
 void embvm::this_thread::sleep_for(const embvm::os_timeout_t& delay) noexcept
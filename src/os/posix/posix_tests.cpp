@@ -5,7 +5,9 @@
 #include <aligned_malloc.h>
 #include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <cerrno>
 #include <chrono>
+#include <string_view>
 #include <thread>
 
 using namespace os;
@@ -80,6 +82,43 @@ TEST_CASE("Create posix thread", "[posix/os/thread]")
 	CHECK(embvm::thread::state::terminated == thread6.state());
 }
 
+TEST_CASE("Apply posix thread options", "[posix/os/thread]")
+{
+	int name_result = -1;
+	int affinity_result = -1;
+	int policy_result = -1;
+	char name[16] = {0};
+
+	std::thread t([&]() {
+		name_result = posix::apply_thread_options({"OptionsThread"});
+
+		posix::thread_options affinity;
+		affinity.cpu_mask = 0x1;
+		affinity_result = posix::apply_thread_options(affinity);
+
+		posix::thread_options policy;
+		policy.policy = posix::sched_policy::fifo;
+		policy.priority = embvm::thread::priority::high;
+		policy_result = posix::apply_thread_options(policy);
+
+#ifdef __linux__
+		pthread_getname_np(pthread_self(), name, sizeof(name));
+#endif
+	});
+	t.join();
+
+	CHECK(0 == name_result);
+#ifdef __linux__
+	CHECK(std::string_view("OptionsThread") == name);
+	CHECK(0 == affinity_result);
+#else
+	CHECK(ENOTSUP == affinity_result);
+#endif
+
+	// Real-time policies require elevated privileges
+	CHECK((0 == policy_result || EPERM == policy_result));
+}
+
 TEST_CASE("Create posix mutex", "[posix/os/mutex]")
 {
 	auto mutex = posix::Mutex();
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <bits/bits.hpp>
 #include <bounce/bounce.hpp>
+#include <cstdint>
 #include <pthread.h>
 #include <rtos/thread.hpp>
 #include <string_view>
@@ -77,6 +78,65 @@ constexpr auto convert_to_pthread_priority(embvm::thread::priority p) noexcept
 	}
 }
 
+/// Scheduling policies which can be applied to a running thread
+enum class sched_policy : uint8_t
+{
+	/// Leave the scheduling policy unchanged
+	inherit = 0,
+	/// Time-sharing (SCHED_OTHER)
+	other,
+	/// Real-time, run to completion unless preempted by a higher priority (SCHED_FIFO)
+	fifo,
+	/// Real-time with time slicing between threads of equal priority (SCHED_RR)
+	rr,
+};
+
+/** Options which can be applied to a running thread.
+ *
+ * The default values leave the thread unchanged.
+ */
+struct thread_options
+{
+	/// The thread name. Linux truncates names to 15 characters. Empty leaves the name unchanged.
+	std::string_view name{};
+
+	/// CPU affinity mask: bit N allows the thread to run on CPU N. 0 leaves affinity unchanged.
+	uint64_t cpu_mask = 0;
+
+	/// The scheduling policy.
+	sched_policy policy = sched_policy::inherit;
+
+	/// The thread priority, used with the fifo and rr policies.
+	embvm::thread::priority priority = embvm::thread::priority::normal;
+};
+
+/** Apply thread options to the calling thread.
+ *
+ * Every option is attempted, even if an earlier option could not be applied.
+ *
+ * This is useful for threads which are not created with os::posix::Thread, such as dispatch
+ * queue workers:
+ *
+ * @code
+ * std::array<os::posix::thread_options, 2> opts = {{
+ * 	{"io-worker-0", 0x1, os::posix::sched_policy::fifo, embvm::thread::priority::high},
+ * 	{"io-worker-1", 0x2, os::posix::sched_policy::fifo, embvm::thread::priority::high},
+ * }};
+ *
+ * embutil::StaticDispatchQueue<32, 2> q("IO Queue", 2, [&opts](size_t worker) {
+ * 	os::posix::apply_thread_options(opts[worker]);
+ * });
+ * @endcode
+ *
+ * @note Real-time policies usually require elevated privileges. Without them, the policy
+ *	cannot be changed and EPERM is returned.
+ *
+ * @param options The options to apply.
+ * @returns 0 on success, or the error code for the first option which could not be applied.
+ *	CPU affinity is only supported on Linux, and returns ENOTSUP on other systems.
+ */
+auto apply_thread_options(const thread_options& options) noexcept -> int;
+
 // TODO: expand creation for numerical thread priority value? just in case?
 
 /// Create a POSIX thread
@@ -241,6 +301,9 @@ class Thread final : public embvm::VirtualThread
 
 		state_ = embvm::thread::state::executing;
 
+		// Make the thread name visible to debuggers and system tools
+		apply_thread_options({name_});
+
 		func_(arg_);
 
 		state_ = embvm::thread::state::completed;
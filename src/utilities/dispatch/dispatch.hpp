@@ -4,18 +4,28 @@
 #ifndef DISPATCH_HPP_
 #define DISPATCH_HPP_
 
+#include <array>
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include "dispatch_coroutine.hpp"
+#include "dispatch_future.hpp"
+#include "dispatch_metrics.hpp"
+#include "dispatch_wait.hpp"
 #include <etl/function.h>
 #include <etl/queue.h>
 #include <etl/vector.h>
 #include <function_queue/function_queue.hpp>
 #include <functional>
 #include <inplace_function/inplace_function.hpp>
+#include <iterator>
 #include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace embutil
@@ -25,6 +35,41 @@ namespace embutil
 /// @ingroup FrameworkUtils
 /// @{
 
+/** Elastic worker configuration for a DynamicDispatchQueue.
+ *
+ * An elastic queue starts with min_threads workers. A worker is added (up to max_threads)
+ * whenever the backlog or the queue wait time passes the thresholds below. Workers above
+ * min_threads exit once they have been idle for idle_timeout.
+ *
+ * @code
+ * embutil::DispatchQueueElasticConfig config;
+ * config.min_threads = 1;
+ * config.max_threads = 8;
+ * config.wait_threshold = std::chrono::milliseconds(5);
+ *
+ * embutil::DynamicDispatchQueue<> q("Elastic Queue", config);
+ * @endcode
+ */
+struct DispatchQueueElasticConfig
+{
+	/// The minimum number of worker threads. These workers are never retired.
+	size_t min_threads = 1;
+
+	/// The maximum number of worker threads.
+	size_t max_threads = 4;
+
+	/// Add a worker when the number of queued operations exceeds the number of idle workers
+	/// by at least this amount. A value of 0 disables backlog-based growth.
+	size_t backlog_threshold = 4;
+
+	/// Add a worker when all workers are busy and the queue has been non-empty for at least
+	/// this long. A value of 0 disables wait-based growth.
+	std::chrono::milliseconds wait_threshold{0};
+
+	/// Retire a worker above min_threads once it has been idle for this long.
+	std::chrono::milliseconds idle_timeout{1000};
+};
+
 /** Base class for dispatch queues
  *
  * This templated base class supports both static and dynamic dispatch queue implementations.
@@ -59,6 +104,9 @@ namespace embutil
  *
  * Dispatch queues cannot be copied or moved.
  *
+ * Dynamic dispatch queues can also be constructed in elastic mode with a
+ * DispatchQueueElasticConfig. The number of worker threads then follows the load on the queue.
+ *
  * @tparam TSize The size of the storage queue. When TSize is 0, dynamic memory allocation will be
  *	used. Otherwise static memory types are used and the maximum number of operations is limited to
  *	TSize.
@@ -68,28 +116,98 @@ namespace embutil
  * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
  * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
  *	variable implementation should be used.
+ * @tparam TDrainCount The maximum number of operations a worker thread removes from the queue
+ *	each time it acquires the lock. The default of 1 takes one operation per lock acquisition.
+ *	Larger values reduce lock traffic for bursts of short operations, at the cost of fairness
+ *	between worker threads.
+ * @tparam TMetrics The runtime metrics type. The default, DispatchQueueNoMetrics, compiles out
+ *	all instrumentation. Use DispatchQueueMetrics to record queue depth, wait time, execution
+ *	time, and per-worker statistics, which are available through metrics().
+ * @tparam TWait The wait strategy used by idle worker threads. The default, DispatchWaitBlock,
+ *	blocks on the condition variable as soon as the queue is empty. DispatchWaitSpin and
+ *	DispatchWaitSpinYield poll the queue before blocking, which avoids a scheduler round-trip
+ *	when work arrives shortly after the queue empties.
  */
 template<const size_t TSize, const size_t TThreadCount,
 		 typename TFunc = stdext::inplace_function<void()>, typename TLock = std::mutex,
-		 typename TCond = std::condition_variable>
+		 typename TCond = std::condition_variable, const size_t TDrainCount = 1,
+		 typename TMetrics = DispatchQueueNoMetrics, typename TWait = DispatchWaitBlock>
 class DispatchQueue_Base
 {
+	static_assert(TDrainCount > 0, "DispatchQueue_Base requires TDrainCount > 0");
+
 	/// Type definition for the thread storage vector.
 	/// If TSize is 0, std::vector will be used (dynamic memory mode). Otherwise an etl::vector
 	/// of size TSize is used.
 	using TVecType = typename std::conditional<(TSize == 0), std::vector<std::thread>,
 											   etl::vector<std::thread, TThreadCount>>::type;
 
+	/// Operation storage for dynamic memory mode.
+	/// The token is only set for operations dispatched with a CancellationToken.
+	struct DynamicEntry
+	{
+		/// The operation.
+		TFunc op{};
+		/// The token which can revoke the operation.
+		const CancellationToken* token = nullptr;
+		/// The token ticket issued when the operation was queued.
+		CancellationToken::ticket_t ticket = 0;
+
+		/// Check whether the operation has been revoked.
+		bool cancelled() const noexcept
+		{
+			return token && token->cancelled(ticket);
+		}
+
+		/// Invoke the operation.
+		void operator()()
+		{
+			op();
+		}
+	};
+
 	/// Type definition for the operation storage queue.
 	/// If TSize is 0, std::queue will be used (dynamic memory mode). Otherwise a
 	/// StaticFunctionQueue of size TSize is used.
-	using TQueueType = typename std::conditional<(TSize == 0), std::queue<TFunc>,
+	using TQueueType = typename std::conditional<(TSize == 0), std::queue<DynamicEntry>,
 												 embutil::StaticFunctionQueue<TSize>>::type;
 
+	/// Type of an operation once it has been removed from the queue.
+	/// This is a DynamicEntry in dynamic memory mode, and a pointer to the FuncOp (which returns
+	/// the memory to the StaticFunctionQueue when destroyed) in static memory mode.
+	using TOpType = std::decay_t<decltype(std::declval<TQueueType&>().front())>;
+
+	/// Queue of pending barrier positions, stored as the sequence number of the barrier operation.
+	/// A barrier occupies a slot in the operation queue, so TSize bounds the number of barriers.
+	using TBarrierQueueType = typename std::conditional<(TSize == 0), std::queue<size_t>,
+														etl::queue<size_t, TSize>>::type;
+
+	/// Timestamp type used to measure how long operations wait in the queue.
+	using TTimePoint = typename TMetrics::time_point;
+
+	/// Duration type used to measure operation execution time.
+	using TDuration = decltype(std::declval<TTimePoint>() - std::declval<TTimePoint>());
+
+	/// Queue of enqueue timestamps, kept in the same order as the operation queue.
+	/// No storage is used when metrics are disabled.
+	using TTimestampQueueType = typename std::conditional<
+		!TMetrics::enabled, std::array<TTimePoint, 0>,
+		typename std::conditional<(TSize == 0), std::queue<TTimePoint>,
+								  etl::queue<TTimePoint, TSize>>::type>::type;
+
+	/// Slots in threads_ whose workers have been retired in elastic mode.
+	/// Elastic mode is only supported in dynamic memory mode, so no storage is used otherwise.
+	using TRetiredType = typename std::conditional<(TSize == 0), std::vector<size_t>,
+												   std::array<size_t, 0>>::type;
+
   public:
 	/// Public alias for the dispatch functor type.
 	using DispatchFunc_t = TFunc;
 
+	/// Functor which is called at the start of each worker thread, with the worker's index.
+	/// Use it to configure the worker, e.g. with os::posix::apply_thread_options().
+	using WorkerInitFunc_t = stdext::inplace_function<void(size_t)>;
+
 	/** Create an unnamed dispatch queue.
 	 *
 	 * Constucts a dispatch queue with a generic name.
@@ -105,7 +223,7 @@ class DispatchQueue_Base
 
 		for(size_t i = 0; i < threads_.capacity(); i++)
 		{
-			threads_.emplace_back(&DispatchQueue_Base::dispatch_thread_handler, this);
+			spawn_worker();
 		}
 	}
 
@@ -114,8 +232,13 @@ class DispatchQueue_Base
 	 * @param thread_count Optional parameter that determines the number of threads associated with
 	 * 	this queue. thread_count cannot exceed TThreadCount.
 	 * @param name The name of the dispatch queue.
+	 * @param init Optional functor which is called at the start of each worker thread, before
+	 *	any operations run. The worker's index is passed as an argument. Anything init references
+	 *	must remain valid for the lifetime of the queue.
 	 */
-	explicit DispatchQueue_Base(const char* name, size_t thread_count = 1) noexcept : name_(name)
+	explicit DispatchQueue_Base(const char* name, size_t thread_count = 1,
+								WorkerInitFunc_t init = nullptr) noexcept
+		: name_(name), init_(std::move(init))
 	{
 		if constexpr(TThreadCount == 0)
 		{
@@ -124,7 +247,38 @@ class DispatchQueue_Base
 
 		for(size_t i = 0; i < thread_count; i++)
 		{
-			threads_.emplace_back(&DispatchQueue_Base::dispatch_thread_handler, this);
+			spawn_worker();
+		}
+	}
+
+	/** Create an elastic dispatch queue.
+	 *
+	 * The queue starts with config.min_threads workers. Workers are added, up to
+	 * config.max_threads, when the backlog or wait time passes the configured thresholds.
+	 * Workers above config.min_threads are retired after they have been idle for
+	 * config.idle_timeout.
+	 *
+	 * @note Elastic mode is only supported by DynamicDispatchQueue.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param config The elastic worker configuration.
+	 * @param init Optional functor which is called at the start of each worker thread, before
+	 *	any operations run. The worker's index is passed as an argument. Anything init references
+	 *	must remain valid for the lifetime of the queue.
+	 */
+	DispatchQueue_Base(const char* name, const DispatchQueueElasticConfig& config,
+					   WorkerInitFunc_t init = nullptr) noexcept
+		: name_(name), elastic_(true), config_(config), init_(std::move(init))
+	{
+		static_assert(TSize == 0, "Elastic mode is only supported by DynamicDispatchQueue");
+		assert(config.max_threads > 0 && config.min_threads <= config.max_threads &&
+			   "Invalid elastic thread bounds");
+
+		threads_.reserve(config.max_threads);
+
+		for(size_t i = 0; i < config.min_threads; i++)
+		{
+			spawn_worker();
 		}
 	}
 
@@ -135,9 +289,13 @@ class DispatchQueue_Base
 	 * valid.
 	 * @param thread_count Optional parameter that determines the number of threads associated with
 	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 * @param init Optional functor which is called at the start of each worker thread, before
+	 *	any operations run. The worker's index is passed as an argument. Anything init references
+	 *	must remain valid for the lifetime of the queue.
 	 */
-	explicit DispatchQueue_Base(const std::string& name, size_t thread_count = 1) noexcept
-		: name_(std::move(name))
+	explicit DispatchQueue_Base(const std::string& name, size_t thread_count = 1,
+								WorkerInitFunc_t init = nullptr) noexcept
+		: name_(std::move(name)), init_(std::move(init))
 	{
 		if constexpr(TThreadCount == 0)
 		{
@@ -146,7 +304,7 @@ class DispatchQueue_Base
 
 		for(size_t i = 0; i < threads_.capacity(); i++)
 		{
-			threads_.emplace_back(&DispatchQueue_Base::dispatch_thread_handler, this);
+			spawn_worker();
 		}
 	}
 
@@ -157,9 +315,13 @@ class DispatchQueue_Base
 	 *	remain valid.
 	 * @param thread_count Optional parameter that determines the number of threads associated with
 	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 * @param init Optional functor which is called at the start of each worker thread, before
+	 *	any operations run. The worker's index is passed as an argument. Anything init references
+	 *	must remain valid for the lifetime of the queue.
 	 */
-	explicit DispatchQueue_Base(const std::string_view name, size_t thread_count = 1) noexcept
-		: name_(std::move(name))
+	explicit DispatchQueue_Base(const std::string_view name, size_t thread_count = 1,
+								WorkerInitFunc_t init = nullptr) noexcept
+		: name_(std::move(name)), init_(std::move(init))
 	{
 		if constexpr(TThreadCount == 0)
 		{
@@ -168,7 +330,7 @@ class DispatchQueue_Base
 
 		for(size_t i = 0; i < threads_.capacity(); i++)
 		{
-			threads_.emplace_back(&DispatchQueue_Base::dispatch_thread_handler, this);
+			spawn_worker();
 		}
 	}
 
@@ -226,14 +388,11 @@ class DispatchQueue_Base
 	 */
 	void dispatch(const TFunc& op) noexcept
 	{
-		if constexpr(TSize > 0)
-		{
-			assert(q_.size() < q_.capacity() &&
-				   "Max dispatch operations reached - increase DispatchQueue_Base::TSize\n");
-		}
-
 		std::unique_lock<TLock> lock(lock_);
-		q_.push(std::move(op));
+
+		check_capacity();
+
+		push(std::move(op));
 
 		// Manual unlocking is done before notifying, to avoid waking up
 		// the waiting thread only to block again (see notify_one for details)
@@ -244,21 +403,236 @@ class DispatchQueue_Base
 	/// @overload void dispatch(const TFunc& op)
 	void dispatch(TFunc&& op) noexcept
 	{
-		if constexpr(TSize > 0)
+		std::unique_lock<TLock> lock(lock_);
+
+		check_capacity();
+
+		push(op);
+
+		// Manual unlocking is done before notifying, to avoid waking up
+		// the waiting thread only to block again (see notify_one for details)
+		lock.unlock();
+		cv_.notify_one();
+	}
+
+	/** Dispatch an operation which can be revoked
+	 *
+	 * Once token.cancel() is called, the operation is discarded without being executed, unless a
+	 * worker thread has already started it. In static memory mode, the operation's queue memory is
+	 * released once it reaches the front of the queue, or when the queue is full, whichever comes
+	 * first.
+	 *
+	 * @code
+	 * embutil::CancellationToken token;
+	 * q.dispatch(poll_sensor, token);
+	 * ...
+	 * token.cancel(); // poll_sensor will not run if it has not started
+	 * @endcode
+	 *
+	 * @param op The operation to dispatch to a worker thread.
+	 * @param token The token which can revoke the operation. The token must outlive the
+	 *	operation's storage in the queue.
+	 */
+	void dispatch(const TFunc& op, const CancellationToken& token) noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		check_capacity();
+		push(op, &token);
+		lock.unlock();
+		cv_.notify_one();
+	}
+
+	/// @overload void dispatch(const TFunc& op, const CancellationToken& token)
+	void dispatch(TFunc&& op, const CancellationToken& token) noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		check_capacity();
+		push(std::move(op), &token);
+		lock.unlock();
+		cv_.notify_one();
+	}
+
+	/** Dispatch a group of operations
+	 *
+	 * All operations are added to the queue while holding the lock once, and worker threads are
+	 * notified once. This reduces per-operation overhead for fan-out patterns, such as
+	 * publishing one event to many subscribers.
+	 *
+	 * @code
+	 * std::array<embutil::StaticDispatchQueue<32>::DispatchFunc_t, 3> ops = {a, b, c};
+	 * q.dispatch_bulk(ops.begin(), ops.end());
+	 * @endcode
+	 *
+	 * @tparam TIterator An iterator type whose value type can be converted to TFunc.
+	 *	Deduced by the compiler.
+	 * @param first Iterator to the first operation to dispatch.
+	 * @param last Iterator one past the last operation to dispatch.
+	 */
+	template<typename TIterator>
+	void dispatch_bulk(TIterator first, TIterator last) noexcept
+	{
+		size_t count = 0;
+
+		std::unique_lock<TLock> lock(lock_);
+		for(; first != last; ++first, ++count)
 		{
-			assert(q_.size() < q_.capacity() &&
-				   "Max dispatch operations reached - increase DispatchQueue_Base::TSize\n");
+			check_capacity();
+
+			push(*first);
+		}
+		lock.unlock();
+
+		if(count == 1)
+		{
+			cv_.notify_one();
+		}
+		else if(count > 1)
+		{
+			cv_.notify_all();
 		}
+	}
+
+	/** Dispatch a group of operations
+	 *
+	 * @overload void dispatch_bulk(TIterator first, TIterator last)
+	 *
+	 * @tparam TContainer Any range type that supports std::begin() and std::end(), such as an
+	 *	array, etl::vector, or span. Deduced by the compiler.
+	 * @param ops The operations to dispatch.
+	 */
+	template<typename TContainer>
+	void dispatch_bulk(const TContainer& ops) noexcept
+	{
+		dispatch_bulk(std::begin(ops), std::end(ops));
+	}
+
+	/** Dispatch an operation as part of a DispatchGroup
+	 *
+	 * The group is entered before the operation is queued, and left once the operation has
+	 * completed. Use the group to wait for (or be notified of) the completion of a set of
+	 * operations.
+	 *
+	 * @code
+	 * embutil::DispatchGroup<> group;
+	 * q.dispatch(group, stage_one_a);
+	 * q.dispatch(group, stage_one_b);
+	 * group.wait();
+	 * @endcode
+	 *
+	 * @tparam TGroup The DispatchGroup type. Deduced by the compiler.
+	 * @param group The group which tracks the operation.
+	 * @param op The operation to dispatch to a worker thread.
+	 */
+	template<typename TGroup, typename = std::enable_if_t<!std::is_invocable_v<TGroup&>>>
+	void dispatch(TGroup& group, TFunc op) noexcept
+	{
+		group.enter();
 
 		std::unique_lock<TLock> lock(lock_);
-		q_.push(op);
 
-		// Manual unlocking is done before notifying, to avoid waking up
-		// the waiting thread only to block again (see notify_one for details)
+		check_capacity();
+
+		push([&group, op = std::move(op)]() {
+			op();
+			group.leave();
+		});
 		lock.unlock();
 		cv_.notify_one();
 	}
 
+	/** Dispatch an operation which produces a result
+	 *
+	 * The result is delivered through a DispatchFuture, whose shared state comes from the
+	 * statically allocated DispatchFuturePool<T>::shared() pool. No dynamic memory is allocated
+	 * by the future.
+	 *
+	 * @code
+	 * auto f = q.dispatch_with_result<int>([] { return compute(); });
+	 * int result = f.get();
+	 * @endcode
+	 *
+	 * @note The operation is stored in a TFunc along with two pointers, so the operation must
+	 *	fit in the remaining TFunc storage.
+	 *
+	 * @tparam T The result type.
+	 * @tparam TPool The DispatchFuturePool type to use. Defaults to a pool of 8 futures.
+	 * @tparam TOp The operation type. Deduced by the compiler.
+	 * @param op The operation to dispatch. Must return a value convertible to T.
+	 * @returns a future which receives the result of op.
+	 */
+	template<typename T, typename TPool = DispatchFuturePool<T>, typename TOp>
+	auto dispatch_with_result(TOp op) noexcept -> DispatchFuture<TPool>
+	{
+		return dispatch_with_result(TPool::shared(), std::move(op));
+	}
+
+	/** Dispatch an operation which produces a result, using a specific future pool.
+	 *
+	 * @overload auto dispatch_with_result(TOp op)
+	 *
+	 * @tparam TPool The DispatchFuturePool type. Deduced by the compiler.
+	 * @tparam TOp The operation type. Deduced by the compiler.
+	 * @param pool The pool which provides the future's shared state.
+	 * @param op The operation to dispatch. Must return a value convertible to
+	 *	TPool::value_type.
+	 * @returns a future which receives the result of op.
+	 */
+	template<typename TPool, typename TOp>
+	auto dispatch_with_result(TPool& pool, TOp op) noexcept -> DispatchFuture<TPool>
+	{
+		auto* state = pool.acquire();
+
+		dispatch([&pool, state, op = std::move(op)]() {
+			state->set_value(op());
+			pool.release(state);
+		});
+
+		return DispatchFuture<TPool>(pool, state);
+	}
+
+	/** Dispatch a barrier operation
+	 *
+	 * A barrier waits for all previously dispatched operations to complete, then runs by itself.
+	 * Operations dispatched after the barrier do not start until the barrier has completed.
+	 * This allows multi-threaded queues to safely separate phases of a pipeline.
+	 *
+	 * On a queue with a single thread, a barrier behaves like a normal operation.
+	 *
+	 * @param op The barrier operation to dispatch.
+	 */
+	void dispatch_barrier(TFunc op) noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+
+		check_capacity();
+
+		barriers_.push(pushed_);
+		push(std::move(op));
+		lock.unlock();
+		cv_.notify_one();
+	}
+
+#if defined(__cpp_impl_coroutine)
+	/** Resume a coroutine on this dispatch queue.
+	 *
+	 * @code
+	 * embutil::DispatchTask<> task(Queue_t& q)
+	 * {
+	 *	co_await q.schedule();
+	 *	// Now running on one of the queue's worker threads
+	 * }
+	 * @endcode
+	 *
+	 * @note Requires C++20.
+	 *
+	 * @returns an awaitable which dispatches the awaiting coroutine to this queue.
+	 */
+	auto schedule() noexcept
+	{
+		return DispatchScheduleAwaitable<DispatchQueue_Base>(*this);
+	}
+#endif
+
 	/** Get a std::bind object for the instance's dispatch(const&) function.
 	 *
 	 * If you need to get the dispatch(const&) variant for another class, use this function
@@ -308,12 +682,34 @@ class DispatchQueue_Base
 	}
 
 	/** Get the number of threads used by this dispatch queue.
+	 *
+	 * In elastic mode, this value changes as workers are added and retired.
 	 *
 	 * @return the number of threads associated with this dispatch queue
 	 */
-	constexpr size_t thread_count() const noexcept
+	size_t thread_count() const noexcept
 	{
-		return threads_.size();
+		return live_threads_;
+	}
+
+	/** Get a snapshot of the queue's runtime metrics.
+	 *
+	 * Metrics are only recorded when the queue is declared with a TMetrics type such as
+	 * DispatchQueueMetrics. Otherwise an empty snapshot is returned.
+	 *
+	 * @returns a copy of the metrics recorded so far.
+	 */
+	typename TMetrics::Snapshot metrics() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		return metrics_.snapshot();
+	}
+
+	/// Clear the queue's runtime metrics.
+	void reset_metrics() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		metrics_.reset();
 	}
 
   private:
@@ -327,8 +723,322 @@ class DispatchQueue_Base
 	TQueueType q_;
 	/// The condition variable which is used to notify dispatch threads.
 	TCond cv_;
+	/// Sequence numbers of barrier operations which have not started yet.
+	TBarrierQueueType barriers_{};
+	/// Number of operations added to the queue.
+	size_t pushed_ = 0;
+	/// Number of operations removed from the queue.
+	size_t popped_ = 0;
+	/// Number of non-barrier operations currently being executed by worker threads.
+	size_t active_ = 0;
+	/// Indicates that a barrier operation is currently executing.
+	bool barrier_running_ = false;
+	/// Number of worker threads which are currently executing operations.
+	size_t busy_ = 0;
+	/// Number of worker threads which have not been retired.
+	std::atomic<size_t> live_threads_ = 0;
+	/// Indicates that the worker count is managed by config_.
+	const bool elastic_ = false;
+	/// Elastic worker configuration (only used when elastic_ is set).
+	const DispatchQueueElasticConfig config_{};
+	/// Slots in threads_ which belong to retired workers.
+	TRetiredType retired_{};
+	/// The time at which the queue last went from empty to non-empty (elastic mode only).
+	std::chrono::steady_clock::time_point backlog_since_{};
+	/// Functor called at the start of each worker thread.
+	const WorkerInitFunc_t init_;
+	/// Runtime metrics storage.
+	TMetrics metrics_{};
+	/// Enqueue timestamps for operations in the queue (only used when metrics are enabled).
+	TTimestampQueueType timestamps_{};
 	/// Flag used to signal to threads that it is time to shutdown the queue.
 	std::atomic<bool> quit_ = false;
+	/// Number of operations in the queue, readable without the lock (polling wait strategies only).
+	std::atomic<size_t> pending_ = 0;
+
+	/// Check that there is room for another operation in static memory mode.
+	/// Operations which are running still hold their StaticFunctionQueue memory, so they count
+	/// toward the capacity. Revoked operations at the front of the queue are discarded first,
+	/// which returns their memory to the pool. If the queue is still full, revoked operations
+	/// are also removed from behind the front of the queue.
+	/// @pre lock_ is held.
+	void check_capacity() noexcept
+	{
+		if constexpr(TSize > 0)
+		{
+			auto in_use = [this] { return q_.size() + active_ + (barrier_running_ ? 1 : 0); };
+
+			discard_cancelled();
+
+			if(in_use() >= q_.capacity())
+			{
+				purge_cancelled();
+			}
+
+			assert(in_use() < q_.capacity() &&
+				   "Max dispatch operations reached - increase DispatchQueue_Base::TSize\n");
+		}
+	}
+
+	/// Add an operation to the queue.
+	/// @param op The operation to add.
+	/// @param token Optional token which can revoke the operation.
+	/// @pre lock_ is held.
+	template<typename TOp>
+	void push(TOp&& op, const CancellationToken* token = nullptr) noexcept
+	{
+		if constexpr(TSize == 0)
+		{
+			if(elastic_ && q_.empty() && config_.wait_threshold.count() > 0)
+			{
+				backlog_since_ = std::chrono::steady_clock::now();
+			}
+		}
+
+		if constexpr(TSize == 0)
+		{
+			q_.push(DynamicEntry{std::forward<TOp>(op), token, token ? token->ticket() : 0});
+		}
+		else if(token)
+		{
+			q_.push(std::forward<TOp>(op), *token);
+		}
+		else
+		{
+			q_.push(std::forward<TOp>(op));
+		}
+
+		pushed_++;
+
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			pending_.store(q_.size(), std::memory_order_relaxed);
+		}
+
+		if constexpr(TMetrics::enabled)
+		{
+			timestamps_.push(TMetrics::clock::now());
+			metrics_.record_dispatch(q_.size());
+		}
+
+		grow_if_needed();
+	}
+
+	/// Remove the operation at the front of the queue.
+	/// Revoked operations which follow it are discarded.
+	/// @pre lock_ is held.
+	TOpType pop() noexcept
+	{
+		auto op = std::move(q_.front());
+		q_.pop();
+		popped_++;
+
+		if constexpr(TMetrics::enabled)
+		{
+			metrics_.record_wait(TMetrics::clock::now() - timestamps_.front());
+			timestamps_.pop();
+		}
+
+		discard_cancelled();
+
+		return op;
+	}
+
+	/// Remove revoked operations from the front of the queue without executing them.
+	/// In static memory mode, their memory is returned to the StaticFunctionQueue pool.
+	/// @pre lock_ is held.
+	void discard_cancelled() noexcept
+	{
+		size_t count = 0;
+
+		if constexpr(TSize == 0)
+		{
+			for(; !q_.empty() && q_.front().cancelled(); count++)
+			{
+				q_.pop();
+			}
+		}
+		else
+		{
+			count = q_.discard_cancelled();
+		}
+
+		// Discarded operations keep their sequence numbers, so barrier positions are unchanged
+		popped_ += count;
+
+		if constexpr(TMetrics::enabled)
+		{
+			for(size_t i = 0; i < count; i++)
+			{
+				timestamps_.pop();
+			}
+		}
+
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			pending_.store(q_.size(), std::memory_order_relaxed);
+		}
+	}
+
+	/// Remove revoked operations from anywhere in the queue (static memory mode only).
+	/// The remaining operations are renumbered, so barrier positions and enqueue timestamps stay
+	/// matched with their operations.
+	/// @pre lock_ is held.
+	void purge_cancelled() noexcept
+	{
+		static_assert(TSize > 0, "purge_cancelled() is only used in static memory mode");
+
+		size_t seq = popped_;
+		size_t removed = 0;
+		size_t barriers = barriers_.size();
+
+		q_.purge_cancelled([&](bool discarded) noexcept {
+			if(discarded)
+			{
+				removed++;
+			}
+			else if(barriers > 0 && barriers_.front() == seq)
+			{
+				// Barriers are never revoked, and are visited in queue order
+				barriers_.pop();
+				barriers_.push(seq - removed);
+				barriers--;
+			}
+
+			if constexpr(TMetrics::enabled)
+			{
+				auto stamp = timestamps_.front();
+				timestamps_.pop();
+
+				if(!discarded)
+				{
+					timestamps_.push(stamp);
+				}
+			}
+
+			seq++;
+		});
+
+		pushed_ -= removed;
+
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			pending_.store(q_.size(), std::memory_order_relaxed);
+		}
+	}
+
+	/// Start a worker thread, reusing the slot of a retired worker if one is available.
+	/// @pre lock_ is held, or no worker threads have been started.
+	void spawn_worker() noexcept
+	{
+		if constexpr(TSize == 0)
+		{
+			if(!retired_.empty())
+			{
+				size_t slot = retired_.back();
+				retired_.pop_back();
+
+				// The retired worker released the lock for the last time before we acquired it,
+				// so it exits without blocking.
+				threads_[slot].join();
+				threads_[slot] =
+					std::thread(&DispatchQueue_Base::dispatch_thread_handler, this, slot);
+				live_threads_++;
+				return;
+			}
+		}
+
+		threads_.emplace_back(&DispatchQueue_Base::dispatch_thread_handler, this, threads_.size());
+		live_threads_++;
+	}
+
+	/// Add a worker thread if the backlog or wait time has passed the elastic thresholds.
+	/// @pre lock_ is held.
+	void grow_if_needed() noexcept
+	{
+		if constexpr(TSize == 0)
+		{
+			if(!elastic_ || quit_ || q_.empty() || live_threads_ >= config_.max_threads)
+			{
+				return;
+			}
+
+			size_t idle = live_threads_ - busy_;
+			bool grow = config_.backlog_threshold > 0 &&
+						q_.size() >= (idle + config_.backlog_threshold);
+
+			if(!grow && idle == 0 && config_.wait_threshold.count() > 0)
+			{
+				grow = (std::chrono::steady_clock::now() - backlog_since_) >=
+					   config_.wait_threshold;
+			}
+
+			if(grow)
+			{
+				spawn_worker();
+			}
+		}
+	}
+
+	/** Wait until work is available or the queue is shutting down.
+	 *
+	 * In elastic mode, a worker above the minimum thread count is retired if it stays idle for
+	 * the configured timeout.
+	 *
+	 * @param lock The held queue lock.
+	 * @param worker The index of the calling worker thread.
+	 * @returns false if the worker has been retired and should exit.
+	 */
+	bool wait_for_work(std::unique_lock<TLock>& lock, size_t worker) noexcept
+	{
+		auto ready = [this] { return (quit_ || work_ready()); };
+
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			if(!ready())
+			{
+				// Poll without the lock so producers are not blocked while we spin
+				lock.unlock();
+				dispatch_poll<TWait>(
+					[this] { return quit_ || pending_.load(std::memory_order_relaxed) > 0; });
+				lock.lock();
+			}
+		}
+
+		if constexpr(TSize == 0)
+		{
+			if(elastic_)
+			{
+				if(cv_.wait_for(lock, config_.idle_timeout, ready) ||
+				   live_threads_ <= config_.min_threads)
+				{
+					return true;
+				}
+
+				retired_.push_back(worker);
+				live_threads_--;
+				return false;
+			}
+		}
+
+		cv_.wait(lock, ready);
+		return true;
+	}
+
+	/// Check whether the next operation in the queue is a barrier.
+	/// @pre lock_ is held.
+	bool barrier_next() const noexcept
+	{
+		return !barriers_.empty() && barriers_.front() == popped_;
+	}
+
+	/// Check whether a worker thread can take operations from the queue.
+	/// A barrier must wait for running operations to finish, and blocks others while it runs.
+	/// @pre lock_ is held.
+	bool work_ready() const noexcept
+	{
+		return q_.size() && !barrier_running_ && !(active_ > 0 && barrier_next());
+	}
 
 	/** Worker thread handler.
 	 *
@@ -337,39 +1047,116 @@ class DispatchQueue_Base
 	 * This function is marked noexcept because we want the program to terminate if an exception
 	 * results from this call. We can't guarantee that ops or the queue won't have exceptions.
 	 *
-	 * - Threads sleep until there is work in the queue (or quit_ is set)
-	 * - Whenever work is available, an operation is popped from the queue
+	 * - The worker init functor, if provided, is called with the worker's index
+	 * - Threads sleep until there is work in the queue (or quit_ is set). Depending on TWait,
+	 *	the queue is polled before the thread blocks.
+	 * - Whenever work is available, up to TDrainCount operations are popped from the queue
 	 *	and processed locally by the worker thread.
+	 * - A barrier operation is only taken once all running operations have completed, and it
+	 *	is executed by itself.
 	 * - When there is no longer any work available, the worker thread sleeps until notified
+	 * - In elastic mode, a worker which sleeps for longer than the idle timeout may be retired
 	 */
-	void dispatch_thread_handler() noexcept
+	void dispatch_thread_handler(size_t worker) noexcept
 	{
+		if(init_)
+		{
+			init_(worker);
+		}
+
+		std::array<TOpType, TDrainCount> batch;
+		[[maybe_unused]] std::array<TDuration, TDrainCount> exec_time{};
 		std::unique_lock<TLock> lock(lock_);
 
 		do
 		{
 			// Wait until we have data or a quit signal
-			cv_.wait(lock, [this] { return (quit_ || q_.size()); });
+			if(!wait_for_work(lock, worker))
+			{
+				break;
+			}
 
 			// after wait, we own the lock
-			if(!quit_ && q_.size())
+			discard_cancelled();
+
+			if(!quit_ && work_ready())
 			{
-				auto op = std::move(q_.front());
-				q_.pop();
+				bool barrier = barrier_next();
+				size_t count = 0;
+
+				if(barrier)
+				{
+					barriers_.pop();
+					barrier_running_ = true;
+					batch[count++] = pop();
+				}
+				else
+				{
+					for(; count < TDrainCount && q_.size() && !barrier_next(); count++)
+					{
+						batch[count] = pop();
+					}
+
+					active_ += count;
+				}
+
+				busy_++;
 
 				// unlock now that we're done messing with the queue
 				lock.unlock();
 
-				if constexpr(TSize > 0)
+				for(size_t i = 0; i < count; i++)
 				{
-					op->exec();
+					[[maybe_unused]] TTimePoint start{};
+
+					if constexpr(TMetrics::enabled)
+					{
+						start = TMetrics::clock::now();
+					}
+
+					if constexpr(TSize > 0)
+					{
+						batch[i]->exec();
+					}
+					else
+					{
+						batch[i]();
+					}
+
+					if constexpr(TMetrics::enabled)
+					{
+						exec_time[i] = TMetrics::clock::now() - start;
+					}
+				}
+
+				lock.lock();
+
+				// Release the operations (and their queue memory) while holding the lock
+				for(size_t i = 0; i < count; i++)
+				{
+					batch[i] = TOpType();
+
+					if constexpr(TMetrics::enabled)
+					{
+						metrics_.record_exec(worker, exec_time[i]);
+					}
+				}
+
+				if(barrier)
+				{
+					// Other workers were held off while the barrier was running
+					barrier_running_ = false;
+					cv_.notify_all();
 				}
 				else
 				{
-					op();
+					active_ -= count;
 				}
 
-				lock.lock();
+				busy_--;
+
+				// Operations may have waited too long while this worker was busy
+				grow_if_needed();
 			}
 		} while(!quit_);
 
@@ -394,10 +1181,15 @@ class DispatchQueue_Base
  * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
  * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
  *	variable implementation should be used.
+ * @tparam TDrainCount The maximum number of operations a worker removes per lock acquisition.
+ * @tparam TMetrics The runtime metrics type. Defaults to no instrumentation.
+ * @tparam TWait The wait strategy used by idle worker threads. Defaults to blocking immediately.
  */
 template<typename TFunc = std::function<void()>, typename TLock = std::mutex,
-		 typename TCond = std::condition_variable>
-using DynamicDispatchQueue = DispatchQueue_Base<0, 0, TFunc, TLock, TCond>;
+		 typename TCond = std::condition_variable, const size_t TDrainCount = 1,
+		 typename TMetrics = DispatchQueueNoMetrics, typename TWait = DispatchWaitBlock>
+using DynamicDispatchQueue =
+	DispatchQueue_Base<0, 0, TFunc, TLock, TCond, TDrainCount, TMetrics, TWait>;
 
 /** Dispatch queue specialization using only static memory allocation.
  *
@@ -421,11 +1213,16 @@ using DynamicDispatchQueue = DispatchQueue_Base<0, 0, TFunc, TLock, TCond>;
  * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
  * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
  *	variable implementation should be used.
+ * @tparam TDrainCount The maximum number of operations a worker removes per lock acquisition.
+ * @tparam TMetrics The runtime metrics type. Defaults to no instrumentation.
+ * @tparam TWait The wait strategy used by idle worker threads. Defaults to blocking immediately.
  */
 template<const size_t TSize, const size_t TThreadCount = 1,
 		 typename TFunc = stdext::inplace_function<void()>, typename TLock = std::mutex,
-		 typename TCond = std::condition_variable>
-using StaticDispatchQueue = DispatchQueue_Base<TSize, TThreadCount, TFunc, TLock, TCond>;
+		 typename TCond = std::condition_variable, const size_t TDrainCount = 1,
+		 typename TMetrics = DispatchQueueNoMetrics, typename TWait = DispatchWaitBlock>
+using StaticDispatchQueue =
+	DispatchQueue_Base<TSize, TThreadCount, TFunc, TLock, TCond, TDrainCount, TMetrics, TWait>;
 
 /// @}
 // End DispatchQueue
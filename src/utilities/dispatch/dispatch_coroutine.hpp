@@ -0,0 +1,340 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef DISPATCH_COROUTINE_HPP_
+#define DISPATCH_COROUTINE_HPP_
+
+// Coroutine support requires C++20. The framework builds with C++17 by default, in which case
+// this header provides nothing.
+#if defined(__cpp_impl_coroutine)
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <etl/vector.h>
+#include <exception>
+#include <mutex>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Static pool of coroutine frames.
+ *
+ * Coroutine frames are normally allocated on the heap. DispatchTask coroutines allocate their
+ * frames from a DispatchFramePool instead, so no dynamic memory is used.
+ *
+ * @tparam TFrameSize The size of each frame, in bytes. A coroutine whose frame is larger than
+ *	TFrameSize triggers an assertion.
+ * @tparam TFrameCount The maximum number of coroutines which can be running at once.
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ */
+template<const size_t TFrameSize = 256, const size_t TFrameCount = 8,
+		 typename TLock = std::mutex>
+class DispatchFramePool
+{
+	static_assert(TFrameCount > 0, "DispatchFramePool requires TFrameCount > 0");
+
+	/// Storage for a single coroutine frame.
+	struct alignas(std::max_align_t) Frame
+	{
+		/// Frame storage.
+		std::byte data[TFrameSize];
+	};
+
+  public:
+	/// Construct a pool with all frames available.
+	DispatchFramePool() noexcept
+	{
+		for(auto& frame : frames_)
+		{
+			free_.push_back(&frame);
+		}
+	}
+
+	/// Deleted copy constructor
+	DispatchFramePool(const DispatchFramePool&) = delete;
+
+	/// Deleted copy assignment operator
+	const DispatchFramePool& operator=(const DispatchFramePool&) = delete;
+
+	/// Deleted move constructor
+	DispatchFramePool(DispatchFramePool&&) = delete;
+
+	/// Deleted move assignment operator
+	DispatchFramePool& operator=(DispatchFramePool&&) = delete;
+
+	/** Get the shared pool for this pool type.
+	 *
+	 * @returns a reference to the statically allocated shared pool.
+	 */
+	static DispatchFramePool& shared() noexcept
+	{
+		static DispatchFramePool pool;
+		return pool;
+	}
+
+	/** Allocate a coroutine frame.
+	 *
+	 * @param size The size of the frame requested by the compiler.
+	 * @returns a pointer to the frame, or nullptr if all frames are in use.
+	 */
+	void* allocate(size_t size) noexcept
+	{
+		assert(size <= TFrameSize &&
+			   "Coroutine frame is too large - increase DispatchFramePool::TFrameSize\n");
+
+		std::lock_guard<TLock> lock(lock_);
+
+		if(size > TFrameSize || free_.empty())
+		{
+			return nullptr;
+		}
+
+		auto* frame = free_.back();
+		free_.pop_back();
+
+		return frame;
+	}
+
+	/** Return a coroutine frame to the pool.
+	 *
+	 * @param ptr The frame to release.
+	 */
+	void deallocate(void* ptr) noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		free_.push_back(static_cast<Frame*>(ptr));
+	}
+
+	/** Get the number of unused frames.
+	 *
+	 * @returns the number of coroutines which can be started before the pool is exhausted.
+	 */
+	size_t available() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		return free_.size();
+	}
+
+  private:
+	/// Lock which protects the free list.
+	TLock lock_;
+	/// Frame storage.
+	std::array<Frame, TFrameCount> frames_;
+	/// Frames which are not in use.
+	etl::vector<Frame*, TFrameCount> free_;
+};
+
+/** Coroutine type for asynchronous flows on dispatch queues.
+ *
+ * A DispatchTask starts running immediately on the calling thread. It runs until it reaches a
+ * co_await expression, and its frame is released when the coroutine returns. Use
+ * DispatchQueue_Base::schedule() to move the coroutine onto a dispatch queue:
+ *
+ * @code
+ * embutil::DispatchTask<> read_sensor(Queue_t& q, I2C_t& i2c, Timer_t& t)
+ * {
+ *	co_await q.schedule();
+ *
+ *	auto status = co_await i2c.transferAsync(start_op);
+ *	co_await embutil::sleep_for(t, std::chrono::milliseconds(10), q);
+ *	status = co_await i2c.transferAsync(read_op);
+ * }
+ * @endcode
+ *
+ * Each step replaces a nested callback, and the coroutine state lives in a single frame taken
+ * from TFramePool rather than in a chain of copied callback objects.
+ *
+ * @note DispatchTask requires C++20.
+ *
+ * @tparam TFramePool The DispatchFramePool type which provides coroutine frames.
+ */
+template<typename TFramePool = DispatchFramePool<>>
+class DispatchTask
+{
+  public:
+	/// Coroutine promise type.
+	struct promise_type
+	{
+		/// Allocate the coroutine frame from the frame pool.
+		static void* operator new(size_t size) noexcept
+		{
+			return TFramePool::shared().allocate(size);
+		}
+
+		/// Return the coroutine frame to the frame pool.
+		static void operator delete(void* ptr) noexcept
+		{
+			TFramePool::shared().deallocate(ptr);
+		}
+
+		/// Called when the frame pool is exhausted. The coroutine does not run.
+		static DispatchTask get_return_object_on_allocation_failure() noexcept
+		{
+			return DispatchTask(false);
+		}
+
+		/// Create the task object returned to the caller.
+		DispatchTask get_return_object() noexcept
+		{
+			return DispatchTask(true);
+		}
+
+		/// Tasks start running immediately.
+		std::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		/// The frame is released when the coroutine returns.
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		/// Tasks do not return a value.
+		void return_void() noexcept {}
+
+		/// Exceptions are not supported.
+		void unhandled_exception() noexcept
+		{
+			std::terminate();
+		}
+	};
+
+	/** Check whether the coroutine was started.
+	 *
+	 * @returns false if the coroutine could not be started because the frame pool was exhausted.
+	 */
+	bool valid() const noexcept
+	{
+		return started_;
+	}
+
+  private:
+	/// Construct a task handle.
+	explicit DispatchTask(bool started) noexcept : started_(started) {}
+
+  private:
+	/// Indicates that the coroutine was started.
+	bool started_;
+};
+
+/** Awaitable which resumes a coroutine on a dispatch queue.
+ *
+ * Returned by DispatchQueue_Base::schedule().
+ *
+ * @tparam TQueue The dispatch queue type.
+ */
+template<typename TQueue>
+class DispatchScheduleAwaitable
+{
+  public:
+	/** Construct the awaitable.
+	 *
+	 * @param q The queue which resumes the coroutine.
+	 */
+	explicit DispatchScheduleAwaitable(TQueue& q) noexcept : q_(q) {}
+
+	/// The coroutine always suspends.
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	/// Dispatch the coroutine to the queue.
+	void await_suspend(std::coroutine_handle<> h) noexcept
+	{
+		q_.dispatch([h]() { h.resume(); });
+	}
+
+	/// Nothing to return.
+	void await_resume() const noexcept {}
+
+  private:
+	/// The queue which resumes the coroutine.
+	TQueue& q_;
+};
+
+/** Awaitable which suspends a coroutine for a period of time.
+ *
+ * Returned by sleep_for().
+ *
+ * @tparam TTimer The timer type. Must provide `asyncDelay(duration, callback)`, such as
+ *	embvm::TimerManager::TimerHandle.
+ * @tparam TQueue The dispatch queue type.
+ * @tparam TDuration The delay type.
+ */
+template<typename TTimer, typename TQueue, typename TDuration>
+class DispatchSleepAwaitable
+{
+  public:
+	/** Construct the awaitable.
+	 *
+	 * @param timer The timer used for the delay.
+	 * @param delay The time to sleep.
+	 * @param q The queue which resumes the coroutine.
+	 */
+	DispatchSleepAwaitable(TTimer& timer, const TDuration& delay, TQueue& q) noexcept
+		: timer_(timer), delay_(delay), q_(q)
+	{
+	}
+
+	/// Delays which have already expired do not suspend.
+	bool await_ready() const noexcept
+	{
+		return delay_ <= TDuration::zero();
+	}
+
+	/// Start the timer. The timeout dispatches the coroutine to the queue.
+	void await_suspend(std::coroutine_handle<> h) noexcept
+	{
+		// Timer callbacks may run with timer locks held, so never resume in the callback
+		timer_.asyncDelay(delay_, [h, q = &q_]() { q->dispatch([h]() { h.resume(); }); });
+	}
+
+	/// Nothing to return.
+	void await_resume() const noexcept {}
+
+  private:
+	/// The timer used for the delay.
+	TTimer& timer_;
+	/// The time to sleep.
+	TDuration delay_;
+	/// The queue which resumes the coroutine.
+	TQueue& q_;
+};
+
+/** Suspend a coroutine for a period of time, then resume it on a dispatch queue.
+ *
+ * @code
+ * auto timer = tm.allocate();
+ * co_await embutil::sleep_for(timer, std::chrono::milliseconds(5), q);
+ * @endcode
+ *
+ * @param timer The timer used for the delay. It must not be used for anything else until the
+ *	coroutine resumes.
+ * @param delay The time to sleep.
+ * @param q The queue which resumes the coroutine.
+ * @returns an awaitable for the delay.
+ */
+template<typename TTimer, typename TRep, typename TPeriod, typename TQueue>
+auto sleep_for(TTimer& timer, const std::chrono::duration<TRep, TPeriod>& delay,
+			   TQueue& q) noexcept
+{
+	return DispatchSleepAwaitable<TTimer, TQueue, std::chrono::duration<TRep, TPeriod>>(timer,
+																						delay, q);
+}
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // __cpp_impl_coroutine
+
+#endif // DISPATCH_COROUTINE_HPP_
@@ -0,0 +1,155 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "dispatch.hpp"
+
+// Coroutine support requires C++20
+#if defined(__cpp_impl_coroutine)
+
+#include "dispatch_coroutine.hpp"
+#include "dispatch_group.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+
+#pragma mark - Helpers -
+
+using Queue_t = embutil::StaticDispatchQueue<16, 2>;
+using TestFramePool = embutil::DispatchFramePool<512, 2>;
+using TestTask = embutil::DispatchTask<TestFramePool>;
+
+/// Awaitable which stores the coroutine handle so the test can resume it manually
+struct ManualEvent
+{
+	std::coroutine_handle<> handle;
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> h) noexcept
+	{
+		handle = h;
+	}
+
+	void await_resume() const noexcept {}
+};
+
+/// Timer which stores the timeout callback so the test controls expiration
+struct ManualTimer
+{
+	stdext::inplace_function<void()> cb;
+
+	template<typename TDuration>
+	void asyncDelay(const TDuration&, stdext::inplace_function<void()>&& func)
+	{
+		cb = std::move(func);
+	}
+};
+
+static TestTask run_on_queue(Queue_t& q, embutil::DispatchGroup<>& group,
+							 std::atomic<bool>& on_caller, std::thread::id caller)
+{
+	co_await q.schedule();
+	on_caller = (std::this_thread::get_id() == caller);
+	group.leave();
+}
+
+static TestTask count_steps(Queue_t& q, embutil::DispatchGroup<>& group, std::atomic<int>& steps)
+{
+	for(int i = 0; i < 10; i++)
+	{
+		co_await q.schedule();
+		steps++;
+	}
+
+	group.leave();
+}
+
+static TestTask wait_for_event(ManualEvent& event, std::atomic<bool>& done)
+{
+	co_await event;
+	done = true;
+}
+
+static TestTask sleep_then_finish(ManualTimer& timer, Queue_t& q, embutil::DispatchGroup<>& group)
+{
+	co_await embutil::sleep_for(timer, std::chrono::milliseconds(10), q);
+	group.leave();
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Coroutine resumes on dispatch queue", "[utility/dispatch/coroutine]")
+{
+	Queue_t q("TestQueue", 2);
+	embutil::DispatchGroup<> group;
+	std::atomic<bool> on_caller = true;
+
+	group.enter();
+	auto task = run_on_queue(q, group, on_caller, std::this_thread::get_id());
+	CHECK(task.valid());
+
+	group.wait();
+	CHECK_FALSE(on_caller);
+}
+
+TEST_CASE("Coroutine steps through multiple dispatches", "[utility/dispatch/coroutine]")
+{
+	Queue_t q("TestQueue", 2);
+	embutil::DispatchGroup<> group;
+	std::atomic<int> steps = 0;
+
+	group.enter();
+	count_steps(q, group, steps);
+	group.wait();
+
+	CHECK(10 == steps);
+}
+
+TEST_CASE("Coroutine frames come from the frame pool", "[utility/dispatch/coroutine]")
+{
+	auto& pool = TestFramePool::shared();
+	ManualEvent e1;
+	ManualEvent e2;
+	ManualEvent e3;
+	std::atomic<bool> done1 = false;
+	std::atomic<bool> done2 = false;
+	std::atomic<bool> done3 = false;
+
+	CHECK(2 == pool.available());
+
+	CHECK(wait_for_event(e1, done1).valid());
+	CHECK(wait_for_event(e2, done2).valid());
+	CHECK(0 == pool.available());
+
+	// The pool is exhausted, so the coroutine is not started
+	CHECK_FALSE(wait_for_event(e3, done3).valid());
+	CHECK_FALSE(e3.handle);
+
+	e1.handle.resume();
+	e2.handle.resume();
+
+	CHECK(done1);
+	CHECK(done2);
+	CHECK_FALSE(done3);
+	CHECK(2 == pool.available());
+}
+
+TEST_CASE("Coroutine sleeps on a timer and resumes on a queue", "[utility/dispatch/coroutine]")
+{
+	Queue_t q("TestQueue", 1);
+	ManualTimer timer;
+	embutil::DispatchGroup<> group;
+
+	group.enter();
+	sleep_then_finish(timer, q, group);
+	CHECK(1 == group.count());
+
+	timer.cb();
+	CHECK(group.wait_for(std::chrono::milliseconds(100)));
+}
+
+#endif // __cpp_impl_coroutine
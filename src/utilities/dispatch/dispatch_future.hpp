@@ -0,0 +1,458 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef DISPATCH_FUTURE_HPP_
+#define DISPATCH_FUTURE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <etl/vector.h>
+#include <inplace_function/inplace_function.hpp>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+template<typename TPool>
+class DispatchFuture;
+
+/** Static pool of shared states for DispatchFuture objects.
+ *
+ * A dispatch future needs state which is shared between the worker thread producing the result
+ * and the thread consuming it. std::promise and std::future allocate that state on the heap.
+ * DispatchFuturePool provides it from static storage instead, so request/response between
+ * subsystems does not require dynamic memory.
+ *
+ * Each state is returned to the pool once both the future and the dispatched operation are done
+ * with it. The pool size therefore bounds the number of outstanding futures.
+ *
+ * @code
+ * embutil::DispatchFuturePool<int, 4> pool;
+ * auto f = q.dispatch_with_result(pool, [] { return read_sensor(); });
+ * int value = f.get();
+ * @endcode
+ *
+ * @tparam T The result type. Must not be void. Use a DispatchGroup to wait for operations which
+ *	do not return a result.
+ * @tparam TPoolSize The maximum number of outstanding futures.
+ * @tparam TCont The storage type for continuations registered with then().
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<typename T, const size_t TPoolSize = 8,
+		 typename TCont = stdext::inplace_function<void(T&)>, typename TLock = std::mutex,
+		 typename TCond = std::condition_variable>
+class DispatchFuturePool
+{
+	static_assert(!std::is_void<T>::value,
+				  "DispatchFuturePool requires a result type. Use a DispatchGroup instead.");
+	static_assert(TPoolSize > 0, "DispatchFuturePool requires TPoolSize > 0");
+
+  public:
+	/// The result type.
+	using value_type = T;
+
+	/// The continuation storage type.
+	using Continuation_t = TCont;
+
+	/// The future type which uses this pool.
+	using Future_t = DispatchFuture<DispatchFuturePool>;
+
+	/// State shared between a future and the operation which produces its result.
+	class State
+	{
+	  public:
+		/// Construct an empty state.
+		State() noexcept = default;
+
+		/// Destroy the state.
+		~State() noexcept
+		{
+			reset();
+		}
+
+		/// Deleted copy constructor
+		State(const State&) = delete;
+
+		/// Deleted copy assignment operator
+		const State& operator=(const State&) = delete;
+
+		/// Deleted move constructor
+		State(State&&) = delete;
+
+		/// Deleted move assignment operator
+		State& operator=(State&&) = delete;
+
+		/** Store the result and release waiting threads.
+		 *
+		 * A registered continuation is invoked on the calling thread.
+		 *
+		 * @param value The result of the operation.
+		 */
+		template<typename TValue>
+		void set_value(TValue&& value) noexcept
+		{
+			TCont cont;
+			std::unique_lock<TLock> lock(lock_);
+
+			assert(!ready_ && "DispatchFuture value set more than once");
+			new(&storage_) T(std::forward<TValue>(value));
+			ready_ = true;
+			std::swap(cont, cont_);
+			cv_.notify_all();
+			lock.unlock();
+
+			if(cont)
+			{
+				cont(this->value());
+			}
+		}
+
+		/// Block until the result is available.
+		void wait() noexcept
+		{
+			std::unique_lock<TLock> lock(lock_);
+			cv_.wait(lock, [this] { return ready_; });
+		}
+
+		/** Block until the result is available, or the timeout expires.
+		 *
+		 * @param timeout The maximum time to wait.
+		 * @returns true if the result is available, false if the timeout expired first.
+		 */
+		template<typename TRep, typename TPeriod>
+		bool wait_for(const std::chrono::duration<TRep, TPeriod>& timeout) noexcept
+		{
+			std::unique_lock<TLock> lock(lock_);
+			return cv_.wait_for(lock, timeout, [this] { return ready_; });
+		}
+
+		/// Check whether the result is available.
+		bool ready() noexcept
+		{
+			std::lock_guard<TLock> lock(lock_);
+			return ready_;
+		}
+
+		/** Register a continuation which receives the result.
+		 *
+		 * If the result is already available, the continuation is invoked immediately on the
+		 * calling thread. Otherwise it is invoked on the thread which produces the result.
+		 *
+		 * @param cont The continuation to invoke.
+		 */
+		void then(TCont cont) noexcept
+		{
+			std::unique_lock<TLock> lock(lock_);
+
+			if(ready_)
+			{
+				lock.unlock();
+				cont(value());
+				return;
+			}
+
+			assert(!cont_ && "Only one continuation can be registered with a DispatchFuture");
+			cont_ = std::move(cont);
+		}
+
+		/// Access the stored result.
+		/// @pre The result is available.
+		T& value() noexcept
+		{
+			return *std::launder(reinterpret_cast<T*>(&storage_));
+		}
+
+	  private:
+		friend class DispatchFuturePool;
+
+		/// Destroy the stored result and continuation so the state can be reused.
+		/// @pre No other thread is using the state.
+		void reset() noexcept
+		{
+			if(ready_)
+			{
+				value().~T();
+				ready_ = false;
+			}
+
+			cont_ = nullptr;
+		}
+
+	  private:
+		/// Lock which protects the state.
+		TLock lock_;
+		/// Condition variable used to release waiting threads.
+		TCond cv_;
+		/// Storage for the result.
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+		/// Indicates that the result has been stored.
+		bool ready_ = false;
+		/// Continuation to invoke when the result is stored.
+		TCont cont_{};
+		/// Number of users of this state (the future and the dispatched operation).
+		std::atomic<uint8_t> refs_ = 0;
+	};
+
+	/// Construct a pool with all states available.
+	DispatchFuturePool() noexcept
+	{
+		for(auto& state : states_)
+		{
+			free_.push_back(&state);
+		}
+	}
+
+	/// Default destructor.
+	/// @pre All futures from this pool have been destroyed and their operations have completed.
+	~DispatchFuturePool() noexcept = default;
+
+	/// Deleted copy constructor
+	DispatchFuturePool(const DispatchFuturePool&) = delete;
+
+	/// Deleted copy assignment operator
+	const DispatchFuturePool& operator=(const DispatchFuturePool&) = delete;
+
+	/// Deleted move constructor
+	DispatchFuturePool(DispatchFuturePool&&) = delete;
+
+	/// Deleted move assignment operator
+	DispatchFuturePool& operator=(DispatchFuturePool&&) = delete;
+
+	/** Get the shared pool for this pool type.
+	 *
+	 * The shared pool is used by dispatch_with_result() when no pool is specified.
+	 *
+	 * @returns a reference to the statically allocated shared pool.
+	 */
+	static DispatchFuturePool& shared() noexcept
+	{
+		static DispatchFuturePool pool;
+		return pool;
+	}
+
+	/** Take a state from the pool.
+	 *
+	 * The state is returned to the pool once release() has been called twice: once by the
+	 * future, and once by the operation which produces the result.
+	 *
+	 * @returns a pointer to an unused state.
+	 */
+	State* acquire() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+
+		assert(!free_.empty() && "DispatchFuturePool exhausted - increase TPoolSize\n");
+		auto* state = free_.back();
+		free_.pop_back();
+		state->refs_ = 2;
+
+		return state;
+	}
+
+	/** Release one reference to a state.
+	 *
+	 * @param state The state to release.
+	 */
+	void release(State* state) noexcept
+	{
+		if(--state->refs_ == 0)
+		{
+			state->reset();
+
+			std::lock_guard<TLock> lock(lock_);
+			free_.push_back(state);
+		}
+	}
+
+	/** Get the number of unused states.
+	 *
+	 * @returns the number of futures which can be created before the pool is exhausted.
+	 */
+	size_t available() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		return free_.size();
+	}
+
+  private:
+	/// Lock which protects the free list.
+	TLock lock_;
+	/// Shared state storage.
+	std::array<State, TPoolSize> states_;
+	/// States which are not in use.
+	etl::vector<State*, TPoolSize> free_;
+};
+
+/** Handle to the result of an operation dispatched with dispatch_with_result().
+ *
+ * A DispatchFuture is a lightweight, move-only handle to a state in a DispatchFuturePool.
+ * No dynamic memory is allocated.
+ *
+ * @code
+ * auto f = q.dispatch_with_result<int>([] { return 42; });
+ *
+ * if(f.wait_for(std::chrono::milliseconds(10)))
+ * {
+ * 	printf("Result: %d\n", f.get());
+ * }
+ * @endcode
+ *
+ * Instead of blocking, a continuation can be registered with then(). The continuation runs on the
+ * worker thread which produced the result (or immediately, if the result is already available):
+ *
+ * @code
+ * q.dispatch_with_result<int>(read_sensor).then([](int& v) { publish(v); });
+ * @endcode
+ *
+ * @note If the dispatch queue is destroyed before the operation runs, the future never becomes
+ *	ready and its state is not returned to the pool.
+ *
+ * @tparam TPool The DispatchFuturePool type which provides the shared state.
+ */
+template<typename TPool>
+class DispatchFuture
+{
+  public:
+	/// The result type.
+	using value_type = typename TPool::value_type;
+
+	/// Construct an invalid future.
+	DispatchFuture() noexcept = default;
+
+	/** Construct a future which owns a reference to a pool state.
+	 *
+	 * @param pool The pool which owns the state.
+	 * @param state The shared state.
+	 */
+	DispatchFuture(TPool& pool, typename TPool::State* state) noexcept
+		: pool_(&pool), state_(state)
+	{
+	}
+
+	/// Release the shared state.
+	~DispatchFuture() noexcept
+	{
+		reset();
+	}
+
+	/// Deleted copy constructor
+	DispatchFuture(const DispatchFuture&) = delete;
+
+	/// Deleted copy assignment operator
+	const DispatchFuture& operator=(const DispatchFuture&) = delete;
+
+	/// Move constructor
+	DispatchFuture(DispatchFuture&& other) noexcept
+		: pool_(other.pool_), state_(std::exchange(other.state_, nullptr))
+	{
+	}
+
+	/// Move assignment operator
+	DispatchFuture& operator=(DispatchFuture&& other) noexcept
+	{
+		if(this != &other)
+		{
+			reset();
+			pool_ = other.pool_;
+			state_ = std::exchange(other.state_, nullptr);
+		}
+
+		return *this;
+	}
+
+	/// Check whether the future refers to a shared state.
+	bool valid() const noexcept
+	{
+		return state_ != nullptr;
+	}
+
+	/// Check whether the result is available.
+	/// @pre valid() is true.
+	bool ready() noexcept
+	{
+		return state_->ready();
+	}
+
+	/// Block until the result is available.
+	/// @pre valid() is true.
+	void wait() noexcept
+	{
+		state_->wait();
+	}
+
+	/** Block until the result is available, or the timeout expires.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units.
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::milli).
+	 *
+	 * @param timeout The maximum time to wait.
+	 * @returns true if the result is available, false if the timeout expired first.
+	 * @pre valid() is true.
+	 */
+	template<typename TRep, typename TPeriod>
+	bool wait_for(const std::chrono::duration<TRep, TPeriod>& timeout) noexcept
+	{
+		return state_->wait_for(timeout);
+	}
+
+	/** Wait for the result and move it out of the shared state.
+	 *
+	 * @returns the result of the operation.
+	 * @pre valid() is true, and get() has not been called before.
+	 */
+	value_type get() noexcept
+	{
+		wait();
+		return std::move(state_->value());
+	}
+
+	/** Register a continuation which receives the result.
+	 *
+	 * The future can be destroyed after calling then(); the continuation is still invoked.
+	 *
+	 * @note Only one continuation can be registered. Do not call get() while a continuation may
+	 *	be running.
+	 *
+	 * @param cont The continuation to invoke with the result.
+	 * @pre valid() is true.
+	 */
+	void then(typename TPool::Continuation_t cont) noexcept
+	{
+		state_->then(std::move(cont));
+	}
+
+  private:
+	/// Release the shared state, if we have one.
+	void reset() noexcept
+	{
+		if(state_)
+		{
+			pool_->release(std::exchange(state_, nullptr));
+		}
+	}
+
+  private:
+	/// The pool which owns the shared state.
+	TPool* pool_ = nullptr;
+	/// The shared state.
+	typename TPool::State* state_ = nullptr;
+};
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // DISPATCH_FUTURE_HPP_
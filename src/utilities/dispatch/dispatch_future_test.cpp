@@ -0,0 +1,124 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "dispatch.hpp"
+#include "dispatch_future.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+
+#pragma mark - Helpers -
+
+static int test_answer(void)
+{
+	return 42;
+}
+
+static int test_slow_answer(void)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	return 42;
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Get result from dispatched operation", "[utility/dispatch/future]")
+{
+	embutil::StaticDispatchQueue<8> q("TestQueue", 1);
+
+	auto f = q.dispatch_with_result<int>(test_answer);
+
+	CHECK(f.valid());
+	CHECK(42 == f.get());
+}
+
+TEST_CASE("Wait for a dispatched result with a timeout", "[utility/dispatch/future]")
+{
+	embutil::StaticDispatchQueue<8> q("TestQueue", 1);
+
+	auto f = q.dispatch_with_result<int>(test_slow_answer);
+
+	CHECK_FALSE(f.wait_for(std::chrono::milliseconds(1)));
+	CHECK(f.wait_for(std::chrono::milliseconds(500)));
+	CHECK(f.ready());
+	CHECK(42 == f.get());
+}
+
+TEST_CASE("Continuation receives dispatched result", "[utility/dispatch/future]")
+{
+	embutil::StaticDispatchQueue<8> q("TestQueue", 1);
+	std::atomic<int> result = 0;
+
+	SECTION("Continuation registered before the result is ready runs on the worker")
+	{
+		std::atomic<bool> on_caller_thread = true;
+		auto caller = std::this_thread::get_id();
+
+		auto f = q.dispatch_with_result<int>(test_slow_answer);
+		f.then([&](int& v) {
+			on_caller_thread = (std::this_thread::get_id() == caller);
+			result = v;
+		});
+
+		f.wait();
+		while(result == 0)
+		{
+			std::this_thread::yield();
+		}
+
+		CHECK(42 == result);
+		CHECK_FALSE(on_caller_thread);
+	}
+
+	SECTION("Continuation registered after the result is ready runs immediately")
+	{
+		auto f = q.dispatch_with_result<int>(test_answer);
+		f.wait();
+
+		f.then([&](int& v) { result = v; });
+		CHECK(42 == result);
+	}
+}
+
+TEST_CASE("Future states are returned to the pool", "[utility/dispatch/future]")
+{
+	embutil::DispatchFuturePool<int, 2> pool;
+	embutil::StaticDispatchQueue<8> q("TestQueue", 1);
+
+	CHECK(2 == pool.available());
+
+	{
+		auto f1 = q.dispatch_with_result(pool, test_answer);
+		auto f2 = q.dispatch_with_result(pool, [] { return 7; });
+		CHECK(0 == pool.available());
+
+		CHECK(42 == f1.get());
+		CHECK(7 == f2.get());
+	}
+
+	// The worker releases its reference after the result is delivered
+	for(int i = 0; i < 100 && pool.available() < 2; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	CHECK(2 == pool.available());
+
+	// A future can be dropped before the result is ready
+	q.dispatch_with_result(pool, test_slow_answer);
+	auto f = q.dispatch_with_result(pool, test_answer);
+	CHECK(42 == f.get());
+}
+
+TEST_CASE("Dynamic queue supports dispatch with result", "[utility/dispatch/future]")
+{
+	embutil::DynamicDispatchQueue<> q("TestQueue", 2);
+	embutil::DispatchFuturePool<std::pair<int, int>, 4> pool;
+
+	auto f = q.dispatch_with_result(pool, [] { return std::make_pair(1, 2); });
+	auto f2 = std::move(f);
+
+	CHECK_FALSE(f.valid());
+	CHECK(std::make_pair(1, 2) == f2.get());
+}
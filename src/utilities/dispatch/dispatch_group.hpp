@@ -0,0 +1,216 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef DISPATCH_GROUP_HPP_
+#define DISPATCH_GROUP_HPP_
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <etl/vector.h>
+#include <inplace_function/inplace_function.hpp>
+#include <mutex>
+#include <utility>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Track completion of a set of dispatched operations.
+ *
+ * A DispatchGroup counts outstanding work. Each unit of work calls enter() before it starts and
+ * leave() when it completes. Other threads can block until all work has completed with wait(),
+ * or register a callback with notify() that is invoked when the count returns to zero.
+ *
+ * Dispatch queues manage enter() and leave() automatically when an operation is dispatched with
+ * a group:
+ *
+ * @code
+ * embutil::DispatchGroup<> group;
+ *
+ * q.dispatch(group, parse_header);
+ * q.dispatch(group, parse_body);
+ * group.notify([] { printf("Parsing complete\n"); });
+ * group.wait();
+ * @endcode
+ *
+ * Groups can be reused once the count returns to zero. All storage is static.
+ *
+ * @note Notification callbacks run on the thread which calls the final leave(). To run the
+ *	callback on a dispatch queue, dispatch from inside the callback.
+ *
+ * @tparam TMaxNotify The maximum number of notification callbacks which can be registered
+ *	while work is outstanding.
+ * @tparam TNotifyFunc The storage type for notification callbacks.
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TMaxNotify = 1, typename TNotifyFunc = stdext::inplace_function<void()>,
+		 typename TLock = std::mutex, typename TCond = std::condition_variable>
+class DispatchGroup
+{
+	static_assert(TMaxNotify > 0, "DispatchGroup requires TMaxNotify > 0");
+
+	/// Storage type for registered notification callbacks.
+	using TNotifyStorage = etl::vector<TNotifyFunc, TMaxNotify>;
+
+  public:
+	/// Construct an empty group.
+	DispatchGroup() noexcept = default;
+
+	/// Destroy the group.
+	/// @pre No work is outstanding.
+	~DispatchGroup() noexcept
+	{
+		assert(count_ == 0 && "DispatchGroup destroyed with outstanding work");
+	}
+
+	/// Deleted copy constructor
+	DispatchGroup(const DispatchGroup&) = delete;
+
+	/// Deleted copy assignment operator
+	const DispatchGroup& operator=(const DispatchGroup&) = delete;
+
+	/// Deleted move constructor
+	DispatchGroup(DispatchGroup&&) = delete;
+
+	/// Deleted move assignment operator
+	DispatchGroup& operator=(DispatchGroup&&) = delete;
+
+	/// Mark the start of a unit of work.
+	void enter() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		count_++;
+	}
+
+	/** Mark the completion of a unit of work.
+	 *
+	 * When the last unit of work leaves, waiting threads are released and registered
+	 * notification callbacks are invoked.
+	 *
+	 * @pre Each leave() call is paired with a previous enter() call.
+	 */
+	void leave() noexcept
+	{
+		TNotifyStorage callbacks;
+		std::unique_lock<TLock> lock(lock_);
+
+		assert(count_ > 0 && "DispatchGroup::leave() called without matching enter()");
+
+		if(--count_ > 0)
+		{
+			return;
+		}
+
+		if(!notify_.empty())
+		{
+			for(auto& cb : notify_)
+			{
+				callbacks.push_back(std::move(cb));
+			}
+
+			notify_.clear();
+
+			// Waiters are held until the callbacks have run
+			notifying_++;
+			lock.unlock();
+
+			for(auto& cb : callbacks)
+			{
+				cb();
+			}
+
+			lock.lock();
+			notifying_--;
+		}
+
+		// Notifying while locked ensures the group is not destroyed while we use cv_
+		cv_.notify_all();
+	}
+
+	/// Block until all outstanding work has completed and notification callbacks have run.
+	void wait() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		cv_.wait(lock, [this] { return done(); });
+	}
+
+	/** Block until all outstanding work has completed, or the timeout expires.
+	 *
+	 * The following template parameters should be automatically deduced by the compiler:
+	 *
+	 * @tparam TRep Underlying storage type (representation) for the time units.
+	 * @tparam TPeriod A std::ratio representing the tick period (e.g., std::milli).
+	 *
+	 * @param timeout The maximum time to wait.
+	 * @returns true if all work completed, false if the timeout expired first.
+	 */
+	template<typename TRep, typename TPeriod>
+	bool wait_for(const std::chrono::duration<TRep, TPeriod>& timeout) noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		return cv_.wait_for(lock, timeout, [this] { return done(); });
+	}
+
+	/** Register a callback which is invoked when all outstanding work completes.
+	 *
+	 * If no work is outstanding, the callback is invoked immediately on the calling thread.
+	 *
+	 * @param cb The callback to invoke.
+	 */
+	void notify(const TNotifyFunc& cb) noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+
+		if(count_ == 0)
+		{
+			lock.unlock();
+			cb();
+			return;
+		}
+
+		assert(notify_.size() < notify_.capacity() &&
+			   "Max notifications reached - increase DispatchGroup::TMaxNotify\n");
+		notify_.push_back(cb);
+	}
+
+	/** Get the amount of outstanding work.
+	 *
+	 * @returns the number of enter() calls which have not been matched by a leave() call.
+	 */
+	size_t count() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		return count_;
+	}
+
+  private:
+	/// Check whether all work and notifications have completed.
+	/// @pre lock_ is held.
+	bool done() const noexcept
+	{
+		return count_ == 0 && notifying_ == 0;
+	}
+
+  private:
+	/// Lock which protects the group state.
+	TLock lock_;
+	/// Condition variable used to release waiting threads.
+	TCond cv_;
+	/// Number of outstanding units of work.
+	size_t count_ = 0;
+	/// Number of threads which are currently running notification callbacks.
+	size_t notifying_ = 0;
+	/// Callbacks to invoke when the outstanding work completes.
+	TNotifyStorage notify_{};
+};
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // DISPATCH_GROUP_HPP_
@@ -0,0 +1,168 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "dispatch.hpp"
+#include "dispatch_group.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+
+#pragma mark - Helpers -
+
+static std::atomic<int> count_ = 0;
+
+static void test_count(void)
+{
+	count_++;
+}
+
+static void test_slow_count(void)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	count_++;
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create dispatch group", "[utility/dispatch/group]")
+{
+	embutil::DispatchGroup<> group;
+
+	CHECK(0 == group.count());
+	CHECK(group.wait_for(std::chrono::milliseconds(0)));
+}
+
+TEST_CASE("Dispatch group counts outstanding work", "[utility/dispatch/group]")
+{
+	embutil::DispatchGroup<> group;
+
+	group.enter();
+	group.enter();
+	CHECK(2 == group.count());
+	CHECK_FALSE(group.wait_for(std::chrono::milliseconds(1)));
+
+	group.leave();
+	group.leave();
+	CHECK(0 == group.count());
+	CHECK(group.wait_for(std::chrono::milliseconds(0)));
+}
+
+TEST_CASE("Dispatch group notifies on completion", "[utility/dispatch/group]")
+{
+	embutil::DispatchGroup<2> group;
+	int notified = 0;
+
+	SECTION("Notify with outstanding work waits for completion")
+	{
+		group.enter();
+		group.notify([&] { notified++; });
+		group.notify([&] { notified++; });
+		CHECK(0 == notified);
+
+		group.leave();
+		CHECK(2 == notified);
+	}
+
+	SECTION("Notify without outstanding work is called immediately")
+	{
+		group.notify([&] { notified++; });
+		CHECK(1 == notified);
+	}
+}
+
+TEST_CASE("Wait for operations dispatched with a group", "[utility/dispatch/group]")
+{
+	const size_t num_threads = 4;
+	embutil::StaticDispatchQueue<32, num_threads> q("TestQueue", num_threads);
+	embutil::DispatchGroup<> group;
+	std::atomic<bool> notified = false;
+	count_ = 0;
+
+	for(size_t i = 0; i < 16; i++)
+	{
+		q.dispatch(group, test_slow_count);
+	}
+
+	group.notify([&] { notified = true; });
+	group.wait();
+
+	CHECK(16 == count_);
+	CHECK(notified);
+}
+
+TEST_CASE("Dynamic queue supports dispatch groups", "[utility/dispatch/group]")
+{
+	embutil::DynamicDispatchQueue<> q("TestQueue", 2);
+	embutil::DispatchGroup<> group;
+	count_ = 0;
+
+	for(size_t i = 0; i < 8; i++)
+	{
+		q.dispatch(group, test_count);
+	}
+
+	CHECK(group.wait_for(std::chrono::milliseconds(100)));
+	CHECK(8 == count_);
+}
+
+TEST_CASE("Barrier waits for earlier operations and blocks later ones",
+		  "[utility/dispatch/barrier]")
+{
+	const size_t num_threads = 4;
+	embutil::StaticDispatchQueue<32, num_threads> q("TestQueue", num_threads);
+	embutil::DispatchGroup<> group;
+	std::atomic<int> seen_by_barrier = -1;
+	std::atomic<int> after_barrier_early = 0;
+	std::atomic<bool> barrier_done = false;
+	count_ = 0;
+
+	for(size_t i = 0; i < 8; i++)
+	{
+		q.dispatch(group, test_slow_count);
+	}
+
+	q.dispatch_barrier([&] {
+		seen_by_barrier = count_.load();
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		barrier_done = true;
+	});
+
+	for(size_t i = 0; i < 8; i++)
+	{
+		q.dispatch(group, [&] {
+			if(!barrier_done)
+			{
+				after_barrier_early++;
+			}
+		});
+	}
+
+	group.wait();
+
+	CHECK(8 == seen_by_barrier);
+	CHECK(0 == after_barrier_early);
+}
+
+TEST_CASE("Barrier on a dynamic queue", "[utility/dispatch/barrier]")
+{
+	embutil::DynamicDispatchQueue<> q("TestQueue", 3);
+	embutil::DispatchGroup<> group;
+	std::atomic<int> seen_by_barrier = -1;
+	count_ = 0;
+
+	for(size_t i = 0; i < 6; i++)
+	{
+		q.dispatch(group, test_slow_count);
+	}
+
+	group.enter();
+	q.dispatch_barrier([&] {
+		seen_by_barrier = count_.load();
+		group.leave();
+	});
+
+	group.wait();
+
+	CHECK(6 == seen_by_barrier);
+}
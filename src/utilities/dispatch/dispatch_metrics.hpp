@@ -0,0 +1,198 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef DISPATCH_METRICS_HPP_
+#define DISPATCH_METRICS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Disabled dispatch queue metrics.
+ *
+ * This is the default metrics type for dispatch queues. No data is recorded, and the queue
+ * compiles out all instrumentation.
+ */
+struct DispatchQueueNoMetrics
+{
+	/// Indicates that instrumentation is disabled.
+	static constexpr bool enabled = false;
+
+	/// Placeholder time point type. No timestamps are recorded.
+	using time_point = char;
+
+	/// Empty snapshot type.
+	struct Snapshot
+	{
+	};
+
+	/// Returns an empty snapshot.
+	Snapshot snapshot() const noexcept
+	{
+		return {};
+	}
+
+	/// Does nothing.
+	void reset() noexcept {}
+};
+
+/** Runtime metrics for a dispatch queue.
+ *
+ * Enable instrumentation by declaring a dispatch queue with this metrics type:
+ *
+ * @code
+ * using Metrics_t = embutil::DispatchQueueMetrics<4>;
+ * embutil::StaticDispatchQueue<32, 4, stdext::inplace_function<void()>, std::mutex,
+ *	std::condition_variable, 1, Metrics_t> q("Instrumented Queue", 4);
+ * ...
+ * auto m = q.metrics();
+ * printf("High water mark: %zu\n", m.high_water_mark);
+ * @endcode
+ *
+ * The following information is recorded:
+ * - The maximum number of operations waiting in the queue (high-water mark)
+ * - A histogram of the time operations wait in the queue before a worker starts them
+ * - A histogram of operation execution time
+ * - The number of operations executed by each worker thread
+ *
+ * Histograms use power-of-two microsecond buckets: bucket 0 counts durations under 1us, and
+ * bucket N counts durations in the range [2^(N-1), 2^N) us. The last bucket also counts all
+ * longer durations.
+ *
+ * The dispatch queue calls the record functions while holding its lock, so this class does not
+ * provide its own synchronization. Read the data through the dispatch queue's metrics() API.
+ *
+ * @tparam TMaxWorkers The maximum number of worker threads which are tracked individually.
+ *	Operations executed by workers with a higher index are not counted per worker.
+ * @tparam THistogramBuckets The number of buckets in each histogram.
+ * @tparam TClock The clock used to measure time. Must satisfy the requirements of a std::chrono
+ *	clock.
+ */
+template<const size_t TMaxWorkers = 8, const size_t THistogramBuckets = 16,
+		 typename TClock = std::chrono::steady_clock>
+class DispatchQueueMetrics
+{
+	static_assert(THistogramBuckets > 1, "DispatchQueueMetrics requires at least 2 buckets");
+
+  public:
+	/// Indicates that instrumentation is enabled.
+	static constexpr bool enabled = true;
+
+	/// Clock used for timestamps.
+	using clock = TClock;
+
+	/// Time point type used for enqueue timestamps.
+	using time_point = typename TClock::time_point;
+
+	/// Histogram storage type.
+	using Histogram = std::array<size_t, THistogramBuckets>;
+
+	/// Copy of the recorded metrics.
+	struct Snapshot
+	{
+		/// The maximum number of operations which were waiting in the queue.
+		size_t high_water_mark;
+
+		/// The total number of operations which have been dispatched.
+		size_t dispatched;
+
+		/// The total number of operations which have completed.
+		size_t completed;
+
+		/// Histogram of the time between dispatch and the start of execution.
+		Histogram wait_time;
+
+		/// Histogram of operation execution time.
+		Histogram exec_time;
+
+		/// The number of operations executed by each worker thread.
+		std::array<size_t, TMaxWorkers> worker_ops;
+	};
+
+	/** Record that an operation has been added to the queue.
+	 *
+	 * @param depth The number of operations in the queue after the addition.
+	 */
+	void record_dispatch(size_t depth) noexcept
+	{
+		data_.dispatched++;
+
+		if(depth > data_.high_water_mark)
+		{
+			data_.high_water_mark = depth;
+		}
+	}
+
+	/** Record the time an operation waited in the queue.
+	 *
+	 * @param wait The time between dispatch and the start of execution.
+	 */
+	void record_wait(typename TClock::duration wait) noexcept
+	{
+		data_.wait_time[bucket(wait)]++;
+	}
+
+	/** Record the completion of an operation.
+	 *
+	 * @param worker The index of the worker thread which executed the operation.
+	 * @param exec The execution time of the operation.
+	 */
+	void record_exec(size_t worker, typename TClock::duration exec) noexcept
+	{
+		data_.completed++;
+		data_.exec_time[bucket(exec)]++;
+
+		if(worker < TMaxWorkers)
+		{
+			data_.worker_ops[worker]++;
+		}
+	}
+
+	/// Get a copy of the recorded metrics.
+	Snapshot snapshot() const noexcept
+	{
+		return data_;
+	}
+
+	/// Clear all recorded metrics.
+	void reset() noexcept
+	{
+		data_ = Snapshot{};
+	}
+
+	/** Get the histogram bucket for a duration.
+	 *
+	 * @param d The duration to classify.
+	 * @returns the bucket index for d.
+	 */
+	static constexpr size_t bucket(typename TClock::duration d) noexcept
+	{
+		auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+		size_t index = 0;
+
+		while(us > 0 && index < (THistogramBuckets - 1))
+		{
+			us >>= 1;
+			index++;
+		}
+
+		return index;
+	}
+
+  private:
+	/// Recorded metrics.
+	Snapshot data_{};
+};
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // DISPATCH_METRICS_HPP_
@@ -0,0 +1,106 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "dispatch.hpp"
+#include "dispatch_group.hpp"
+#include "dispatch_metrics.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+#pragma mark - Helpers -
+
+using Metrics_t = embutil::DispatchQueueMetrics<4>;
+using InstrumentedQueue_t =
+	embutil::StaticDispatchQueue<16, 2, stdext::inplace_function<void()>, std::mutex,
+								 std::condition_variable, 1, Metrics_t>;
+
+static void test_nop(void) {}
+
+static void test_sleep(void)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+template<typename THistogram>
+static size_t histogram_total(const THistogram& h)
+{
+	return std::accumulate(h.begin(), h.end(), size_t(0));
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Metrics histogram buckets", "[utility/dispatch/metrics]")
+{
+	using namespace std::chrono;
+
+	CHECK(0 == Metrics_t::bucket(nanoseconds(500)));
+	CHECK(1 == Metrics_t::bucket(microseconds(1)));
+	CHECK(2 == Metrics_t::bucket(microseconds(3)));
+	CHECK(10 == Metrics_t::bucket(milliseconds(1)));
+	CHECK(15 == Metrics_t::bucket(seconds(10)));
+}
+
+TEST_CASE("Metrics track queue high water mark", "[utility/dispatch/metrics]")
+{
+	const size_t num_threads = 0;
+	InstrumentedQueue_t q("TestQueue", num_threads);
+
+	for(size_t i = 0; i < 5; i++)
+	{
+		q.dispatch(test_nop);
+	}
+
+	auto m = q.metrics();
+	CHECK(5 == m.high_water_mark);
+	CHECK(5 == m.dispatched);
+	CHECK(0 == m.completed);
+
+	q.reset_metrics();
+	CHECK(0 == q.metrics().high_water_mark);
+}
+
+TEST_CASE("Metrics record wait and execution time", "[utility/dispatch/metrics]")
+{
+	const size_t num_threads = 2;
+	InstrumentedQueue_t q("TestQueue", num_threads);
+	embutil::DispatchGroup<> group;
+
+	for(size_t i = 0; i < 8; i++)
+	{
+		q.dispatch(group, test_sleep);
+	}
+
+	group.wait();
+
+	// The group is left inside the operation, so give the workers time to record completion
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+	auto m = q.metrics();
+	CHECK(8 == m.dispatched);
+	CHECK(8 == m.completed);
+	CHECK(8 == histogram_total(m.wait_time));
+	CHECK(8 == histogram_total(m.exec_time));
+	CHECK(8 == m.worker_ops[0] + m.worker_ops[1]);
+
+	// Every operation sleeps for at least 1ms, which is bucket 10 or higher
+	CHECK(0 == std::accumulate(m.exec_time.begin(), m.exec_time.begin() + 10, size_t(0)));
+}
+
+TEST_CASE("Dynamic queue supports metrics", "[utility/dispatch/metrics]")
+{
+	embutil::DynamicDispatchQueue<std::function<void()>, std::mutex, std::condition_variable, 1,
+								  Metrics_t>
+		q("TestQueue", 1);
+
+	q.dispatch(test_nop);
+	q.dispatch(test_nop);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+	auto m = q.metrics();
+	CHECK(2 == m.dispatched);
+	CHECK(2 == m.completed);
+	CHECK(2 == m.worker_ops[0]);
+}
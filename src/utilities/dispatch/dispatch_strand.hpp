@@ -0,0 +1,239 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef DISPATCH_STRAND_HPP_
+#define DISPATCH_STRAND_HPP_
+
+#include <cassert>
+#include <condition_variable>
+#include <function_queue/function_queue.hpp>
+#include <mutex>
+#include <queue>
+#include <type_traits>
+#include <utility>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Serial queue which runs on a shared dispatch queue.
+ *
+ * A strand guarantees that its operations run in FIFO order and never concurrently with each
+ * other, like a dispatch queue with a single thread. Unlike a single-threaded dispatch queue,
+ * a strand does not own a thread. Its operations are executed by the worker threads of a shared
+ * dispatch queue. Many subsystems can each use their own strand while sharing a small pool of
+ * worker threads (and their stacks).
+ *
+ * @code
+ * embutil::StaticDispatchQueue<32, 4> pool("Shared Pool", 4);
+ * embutil::DispatchStrand<decltype(pool), 16> sensor_strand(pool);
+ * embutil::DispatchStrand<decltype(pool), 16> display_strand(pool);
+ *
+ * sensor_strand.dispatch(read_sensor);
+ * sensor_strand.dispatch(process_sample); // Runs after read_sensor completes
+ * display_strand.dispatch(redraw); // May run concurrently with the sensor strand
+ * @endcode
+ *
+ * While a strand has pending operations, it occupies one slot in the shared queue. A worker runs
+ * up to TBurst operations from the strand, then re-dispatches the strand to the shared queue so
+ * that other work is not starved.
+ *
+ * @note The strand must be destroyed before the shared queue. The destructor blocks until all
+ *	pending operations have run.
+ *
+ * @tparam TQueue The shared dispatch queue type.
+ * @tparam TSize The size of the strand's operation queue. When TSize is 0, dynamic memory
+ *	allocation will be used. Otherwise static memory is used and the maximum number of pending
+ *	operations is limited to TSize.
+ * @tparam TBurst The maximum number of operations run each time a worker services the strand.
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<typename TQueue, const size_t TSize = 0, const size_t TBurst = 8,
+		 typename TLock = std::mutex, typename TCond = std::condition_variable>
+class DispatchStrand
+{
+	static_assert(TBurst > 0, "DispatchStrand requires TBurst > 0");
+
+	/// The dispatch functor type, which matches the shared queue.
+	using TFunc = typename TQueue::DispatchFunc_t;
+
+	/// Type definition for the operation storage queue.
+	/// If TSize is 0, std::queue will be used (dynamic memory mode). Otherwise a
+	/// StaticFunctionQueue of size TSize is used.
+	using TQueueType = typename std::conditional<(TSize == 0), std::queue<TFunc>,
+												 embutil::StaticFunctionQueue<TSize>>::type;
+
+  public:
+	/// Public alias for the dispatch functor type.
+	using DispatchFunc_t = TFunc;
+
+	/** Create a strand on a shared dispatch queue.
+	 *
+	 * @param queue The dispatch queue which executes the strand's operations.
+	 */
+	explicit DispatchStrand(TQueue& queue) noexcept : queue_(queue) {}
+
+	/** Destroy the strand.
+	 *
+	 * Blocks until all pending operations have run.
+	 *
+	 * @pre The shared queue has not been destroyed.
+	 */
+	~DispatchStrand() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		cv_.wait(lock, [this] { return !scheduled_; });
+	}
+
+	/// Deleted copy constructor
+	DispatchStrand(const DispatchStrand&) = delete;
+
+	/// Deleted copy assignment operator
+	const DispatchStrand& operator=(const DispatchStrand&) = delete;
+
+	/// Deleted move constructor
+	DispatchStrand(DispatchStrand&&) = delete;
+
+	/// Deleted move assignment operator
+	DispatchStrand& operator=(DispatchStrand&&) = delete;
+
+	/** Dispatch an operation to the strand.
+	 *
+	 * The operation runs on a worker thread of the shared queue after all operations previously
+	 * dispatched to this strand have completed.
+	 *
+	 * @param op The operation to dispatch.
+	 */
+	void dispatch(const TFunc& op) noexcept
+	{
+		push(op);
+	}
+
+	/// @overload void dispatch(const TFunc& op)
+	void dispatch(TFunc&& op) noexcept
+	{
+		push(std::move(op));
+	}
+
+	/** Dispatch an operation to the strand as part of a DispatchGroup
+	 *
+	 * The group is entered before the operation is queued, and left once the operation has
+	 * completed.
+	 *
+	 * @tparam TGroup The DispatchGroup type. Deduced by the compiler.
+	 * @param group The group which tracks the operation.
+	 * @param op The operation to dispatch.
+	 */
+	template<typename TGroup>
+	void dispatch(TGroup& group, TFunc op) noexcept
+	{
+		group.enter();
+		push([&group, op = std::move(op)]() {
+			op();
+			group.leave();
+		});
+	}
+
+	/** Get the current size of the strand's operation queue.
+	 *
+	 * @returns the number of operations which have not started yet.
+	 */
+	size_t queue_size() noexcept
+	{
+		std::lock_guard<TLock> lock(lock_);
+		return q_.size();
+	}
+
+  private:
+	/// Add an operation and schedule the strand on the shared queue if it is idle.
+	/// The running operation still holds its StaticFunctionQueue memory, so it counts toward
+	/// the capacity.
+	template<typename TOp>
+	void push(TOp&& op) noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+
+		if constexpr(TSize > 0)
+		{
+			assert(q_.size() + (running_ ? 1 : 0) < q_.capacity() &&
+				   "Max strand operations reached - increase DispatchStrand::TSize\n");
+		}
+
+		q_.push(std::forward<TOp>(op));
+
+		if(!scheduled_)
+		{
+			scheduled_ = true;
+			lock.unlock();
+			queue_.dispatch([this]() { run(); });
+		}
+	}
+
+	/// Run pending operations on a worker thread of the shared queue.
+	void run() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+
+		for(size_t i = 0; i < TBurst && q_.size(); i++)
+		{
+			if constexpr(TSize > 0)
+			{
+				auto op = q_.front();
+				q_.pop();
+				running_ = true;
+				lock.unlock();
+				op->exec();
+				lock.lock();
+
+				// Release the operation (and its queue memory) while holding the lock
+				op.reset();
+				running_ = false;
+			}
+			else
+			{
+				auto op = std::move(q_.front());
+				q_.pop();
+				lock.unlock();
+				op();
+				lock.lock();
+			}
+		}
+
+		if(q_.size())
+		{
+			// Yield the worker, and continue once other queued work has had a turn
+			lock.unlock();
+			queue_.dispatch([this]() { run(); });
+			return;
+		}
+
+		scheduled_ = false;
+
+		// Notifying while locked ensures the strand is not destroyed while we use cv_
+		cv_.notify_all();
+	}
+
+  private:
+	/// The shared queue which executes operations.
+	TQueue& queue_;
+	/// Lock which protects the strand state.
+	TLock lock_;
+	/// Condition variable used to wait for the strand to drain.
+	TCond cv_;
+	/// The strand's pending operations.
+	TQueueType q_;
+	/// Indicates that the strand has been dispatched to the shared queue.
+	bool scheduled_ = false;
+	/// Indicates that one of the strand's operations is executing.
+	bool running_ = false;
+};
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // DISPATCH_STRAND_HPP_
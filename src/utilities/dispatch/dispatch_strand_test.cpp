@@ -0,0 +1,158 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "dispatch.hpp"
+#include "dispatch_group.hpp"
+#include "dispatch_strand.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#pragma mark - Helpers -
+
+using Pool_t = embutil::StaticDispatchQueue<32, 4>;
+
+/// Tracks concurrent execution within a strand
+struct StrandTracker
+{
+	std::atomic<int> running = 0;
+	std::atomic<bool> overlapped = false;
+	std::vector<int> order;
+
+	void run(int value)
+	{
+		if(++running > 1)
+		{
+			overlapped = true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		order.push_back(value);
+		running--;
+	}
+};
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Strand runs operations in order without overlap", "[utility/dispatch/strand]")
+{
+	Pool_t pool("Shared Pool", 4);
+	embutil::DispatchGroup<> group;
+	StrandTracker tracker;
+
+	{
+		embutil::DispatchStrand<Pool_t, 32> strand(pool);
+
+		for(int i = 0; i < 20; i++)
+		{
+			strand.dispatch(group, [&tracker, i] { tracker.run(i); });
+		}
+
+		group.wait();
+	}
+
+	CHECK_FALSE(tracker.overlapped);
+	REQUIRE(20 == tracker.order.size());
+
+	for(int i = 0; i < 20; i++)
+	{
+		CHECK(i == tracker.order[static_cast<size_t>(i)]);
+	}
+}
+
+TEST_CASE("Strands share a pool and run concurrently", "[utility/dispatch/strand]")
+{
+	Pool_t pool("Shared Pool", 4);
+	StrandTracker tracker_a;
+	StrandTracker tracker_b;
+	std::atomic<int> concurrent = 0;
+	std::atomic<int> max_concurrent = 0;
+
+	auto op = [&](StrandTracker& t, int v) {
+		int now = ++concurrent;
+		int prev = max_concurrent;
+		while(now > prev && !max_concurrent.compare_exchange_weak(prev, now))
+		{
+		}
+
+		t.run(v);
+		concurrent--;
+	};
+
+	{
+		embutil::DispatchStrand<Pool_t, 16> strand_a(pool);
+		embutil::DispatchStrand<Pool_t, 16> strand_b(pool);
+
+		for(int i = 0; i < 10; i++)
+		{
+			strand_a.dispatch([&, i] { op(tracker_a, i); });
+			strand_b.dispatch([&, i] { op(tracker_b, i); });
+		}
+
+		// Destroying the strands waits for their operations to complete
+	}
+
+	CHECK(10 == tracker_a.order.size());
+	CHECK(10 == tracker_b.order.size());
+	CHECK_FALSE(tracker_a.overlapped);
+	CHECK_FALSE(tracker_b.overlapped);
+	CHECK(2 == max_concurrent);
+}
+
+TEST_CASE("Strand on a dynamic dispatch queue", "[utility/dispatch/strand]")
+{
+	embutil::DynamicDispatchQueue<> pool("Shared Pool", 2);
+	StrandTracker tracker;
+
+	{
+		embutil::DispatchStrand<embutil::DynamicDispatchQueue<>, 0, 2> strand(pool);
+
+		for(int i = 0; i < 10; i++)
+		{
+			strand.dispatch([&tracker, i] { tracker.run(i); });
+		}
+	}
+
+	CHECK_FALSE(tracker.overlapped);
+	CHECK(std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9} == tracker.order);
+}
+
+TEST_CASE("Running strand operation counts toward the strand capacity",
+		  "[utility/dispatch/strand]")
+{
+	Pool_t pool("Shared Pool", 2);
+	std::atomic<bool> started = false;
+	std::atomic<bool> gate = false;
+	std::atomic<int> count = 0;
+
+	{
+		embutil::DispatchStrand<Pool_t, 4> strand(pool);
+
+		strand.dispatch([&] {
+			started = true;
+			while(!gate)
+			{
+				std::this_thread::yield();
+			}
+		});
+
+		while(!started)
+		{
+			std::this_thread::yield();
+		}
+
+		// The running operation still holds one of the strand's slots
+		for(int i = 0; i < 3; i++)
+		{
+			strand.dispatch([&count] { count++; });
+		}
+
+		CHECK(3 == strand.queue_size());
+
+		gate = true;
+	}
+
+	CHECK(3 == count);
+}
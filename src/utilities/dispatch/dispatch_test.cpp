@@ -2,10 +2,13 @@
 // SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
 
 #include "dispatch.hpp"
+#include <array>
 #include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 using namespace embutil;
 
@@ -23,6 +26,22 @@ static void test_count(void)
 	flag = flag + 1;
 }
 
+static constexpr int bench_ops = 1000;
+
+// Safe to call from multiple worker threads, unlike test_count()
+static void test_increment(void)
+{
+	flag++;
+}
+
+static void wait_for_flag(int value)
+{
+	while(flag < value)
+	{
+		std::this_thread::yield();
+	}
+}
+
 #pragma mark - Test Cases -
 
 TEST_CASE("Create dynamic dispatch queue", "[utility/dispatch/dynamic]")
@@ -103,3 +122,288 @@ TEST_CASE("Add to dynamic dispatch queue then empty", "[utility/dispatch/dynamic
 
 	CHECK(flag == 10);
 }
+
+TEST_CASE("Dynamic dispatch_bulk adds all operations to queue", "[utility/dispatch/dynamic]")
+{
+	const size_t num_threads = 0;
+	embutil::DynamicDispatchQueue<> q("TestQueue", num_threads);
+	std::vector<embutil::DynamicDispatchQueue<>::DispatchFunc_t> ops(10, test_count);
+
+	q.dispatch_bulk(ops);
+
+	CHECK(10 == q.queue_size());
+}
+
+TEST_CASE("Dynamic dispatch_bulk operations run", "[utility/dispatch/dynamic]")
+{
+	const size_t num_threads = 2;
+	flag = 0;
+	embutil::DynamicDispatchQueue<> q("TestQueue", num_threads);
+	std::array<embutil::DynamicDispatchQueue<>::DispatchFunc_t, 3> ops = {
+		test_increment, test_increment, test_increment};
+
+	q.dispatch_bulk(ops.begin(), ops.end());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(flag == 3);
+}
+
+TEST_CASE("Dynamic dispatch queue drains multiple operations per wakeup",
+		  "[utility/dispatch/dynamic]")
+{
+	using Queue_t = embutil::DynamicDispatchQueue<std::function<void()>, std::mutex,
+												  std::condition_variable, 4>;
+	flag = 0;
+	Queue_t q("TestQueue");
+	std::vector<Queue_t::DispatchFunc_t> ops(10, test_increment);
+
+	q.dispatch_bulk(ops);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(flag == 10);
+	CHECK(0 == q.queue_size());
+}
+
+TEST_CASE("Worker init functor runs once for each worker", "[utility/dispatch/dynamic]")
+{
+	std::atomic<int> started = 0;
+	std::array<std::atomic<int>, 3> workers = {0, 0, 0};
+
+	{
+		embutil::DynamicDispatchQueue<> q("TestQueue", 3, [&](size_t worker) {
+			workers[worker]++;
+			started++;
+		});
+
+		while(started < 3)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	CHECK(3 == started);
+	CHECK(1 == workers[0]);
+	CHECK(1 == workers[1]);
+	CHECK(1 == workers[2]);
+}
+
+TEST_CASE("Cancelled operations do not run on dynamic queue", "[utility/dispatch/dynamic]")
+{
+	embutil::DynamicDispatchQueue<> q("TestQueue");
+	embutil::CancellationToken token;
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	flag = 0;
+
+	// Hold the worker thread so the following operations stay queued
+	q.dispatch([&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	for(int i = 0; i < 5; i++)
+	{
+		q.dispatch(test_increment, token);
+	}
+
+	q.dispatch(test_increment);
+	token.cancel();
+	q.dispatch([] { flag += 10; }, token);
+
+	release = true;
+	wait_for_flag(11);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	CHECK(0 == q.queue_size());
+	CHECK(11 == flag);
+}
+
+TEST_CASE("Elastic dispatch queue starts with the minimum thread count",
+		  "[utility/dispatch/dynamic/elastic]")
+{
+	embutil::DispatchQueueElasticConfig config;
+	config.min_threads = 2;
+	config.max_threads = 4;
+	embutil::DynamicDispatchQueue<> q("TestQueue", config);
+
+	CHECK(2 == q.thread_count());
+}
+
+TEST_CASE("Elastic dispatch queue grows with backlog and retires idle workers",
+		  "[utility/dispatch/dynamic/elastic]")
+{
+	embutil::DispatchQueueElasticConfig config;
+	config.min_threads = 1;
+	config.max_threads = 4;
+	config.backlog_threshold = 1;
+	config.idle_timeout = std::chrono::milliseconds(20);
+	embutil::DynamicDispatchQueue<> q("TestQueue", config);
+	flag = 0;
+
+	for(int i = 0; i < 8; i++)
+	{
+		q.dispatch([] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			test_increment();
+		});
+	}
+
+	CHECK(4 == q.thread_count());
+
+	wait_for_flag(8);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	CHECK(1 == q.thread_count());
+
+	// Retired slots are reused when the queue grows again
+	for(int i = 0; i < 8; i++)
+	{
+		q.dispatch([] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			test_increment();
+		});
+	}
+
+	CHECK(4 == q.thread_count());
+	wait_for_flag(16);
+}
+
+TEST_CASE("Elastic dispatch queue grows when operations wait too long",
+		  "[utility/dispatch/dynamic/elastic]")
+{
+	embutil::DispatchQueueElasticConfig config;
+	config.min_threads = 1;
+	config.max_threads = 2;
+	config.backlog_threshold = 0;
+	config.wait_threshold = std::chrono::milliseconds(5);
+	embutil::DynamicDispatchQueue<> q("TestQueue", config);
+	flag = 0;
+
+	auto slow_op = [] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(30));
+		test_increment();
+	};
+
+	q.dispatch(slow_op);
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	q.dispatch(slow_op);
+	CHECK(1 == q.thread_count());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	q.dispatch(test_increment);
+	CHECK(2 == q.thread_count());
+
+	wait_for_flag(3);
+}
+
+TEST_CASE("Dispatch queue with polling wait strategy runs operations",
+		  "[utility/dispatch/dynamic]")
+{
+	flag = 0;
+
+	{
+		embutil::DynamicDispatchQueue<std::function<void()>, std::mutex, std::condition_variable,
+									  1, embutil::DispatchQueueNoMetrics,
+									  embutil::DispatchWaitSpinYield<>>
+			q("TestQueue", 2);
+
+		for(int i = 0; i < 10; i++)
+		{
+			q.dispatch(test_increment);
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+
+		wait_for_flag(10);
+	}
+
+	CHECK(flag == 10);
+}
+
+TEST_CASE("Dispatch fan-out benchmark", "[utility/dispatch/dynamic][!benchmark]")
+{
+	const size_t num_threads = 2;
+	using DrainQueue_t = embutil::DynamicDispatchQueue<std::function<void()>, std::mutex,
+													   std::condition_variable, 16>;
+	std::vector<embutil::DynamicDispatchQueue<>::DispatchFunc_t> ops(bench_ops, test_increment);
+
+	BENCHMARK("Per-operation dispatch")
+	{
+		flag = 0;
+		embutil::DynamicDispatchQueue<> q("BenchQueue", num_threads);
+
+		for(const auto& op : ops)
+		{
+			q.dispatch(op);
+		}
+
+		wait_for_flag(bench_ops);
+	};
+
+	BENCHMARK("dispatch_bulk")
+	{
+		flag = 0;
+		embutil::DynamicDispatchQueue<> q("BenchQueue", num_threads);
+
+		q.dispatch_bulk(ops);
+
+		wait_for_flag(bench_ops);
+	};
+
+	BENCHMARK("dispatch_bulk, drain 16 per wakeup")
+	{
+		flag = 0;
+		DrainQueue_t q("BenchQueue", num_threads);
+
+		q.dispatch_bulk(ops);
+
+		wait_for_flag(bench_ops);
+	};
+}
+
+TEST_CASE("Dispatch wakeup latency benchmark", "[utility/dispatch/dynamic][!benchmark]")
+{
+	using Func_t = embutil::DynamicDispatchQueue<>::DispatchFunc_t;
+	using SpinQueue_t =
+		embutil::DynamicDispatchQueue<Func_t, std::mutex, std::condition_variable, 1,
+									  embutil::DispatchQueueNoMetrics, embutil::DispatchWaitSpin<>>;
+	using SpinYieldQueue_t = embutil::DynamicDispatchQueue<
+		Func_t, std::mutex, std::condition_variable, 1, embutil::DispatchQueueNoMetrics,
+		embutil::DispatchWaitSpinYield<>>;
+
+	// Dispatch a single operation and wait for it to complete
+	auto round_trip = [](auto& q) {
+		int expected = flag + 1;
+		q.dispatch(test_increment);
+		wait_for_flag(expected);
+	};
+
+	flag = 0;
+	embutil::DynamicDispatchQueue<> block_q("BenchQueue", 1);
+	SpinQueue_t spin_q("BenchQueue", 1);
+	SpinYieldQueue_t spin_yield_q("BenchQueue", 1);
+
+	BENCHMARK("Block")
+	{
+		round_trip(block_q);
+	};
+
+	BENCHMARK("Spin")
+	{
+		round_trip(spin_q);
+	};
+
+	BENCHMARK("Spin, yield")
+	{
+		round_trip(spin_yield_q);
+	};
+}
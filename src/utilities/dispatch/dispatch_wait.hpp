@@ -0,0 +1,121 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef DISPATCH_WAIT_HPP_
+#define DISPATCH_WAIT_HPP_
+
+#include <cstddef>
+#include <thread>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Wait strategy which blocks as soon as there is no work.
+ *
+ * This is the default wait strategy. Idle worker threads use no CPU time, but each wakeup
+ * requires a trip through the OS scheduler.
+ */
+struct DispatchWaitBlock
+{
+	/// Number of times to poll for work with a CPU pause between checks.
+	static constexpr size_t spin_count = 0;
+	/// Number of times to poll for work with a thread yield between checks.
+	static constexpr size_t yield_count = 0;
+};
+
+/** Wait strategy which polls for work before blocking.
+ *
+ * A worker polls TSpinCount times, pausing the CPU between checks, and then blocks.
+ * Work which arrives during the spin phase is picked up without a scheduler round-trip,
+ * at the cost of keeping the core busy while the worker spins.
+ *
+ * @note Polling only helps when the producer runs on a different core than the worker. On a
+ *	single-core system the worker delays the producer while it spins, so use DispatchWaitBlock.
+ *
+ * @tparam TSpinCount The number of times to poll before blocking.
+ */
+template<const size_t TSpinCount = 1000>
+struct DispatchWaitSpin
+{
+	/// Number of times to poll for work with a CPU pause between checks.
+	static constexpr size_t spin_count = TSpinCount;
+	/// Number of times to poll for work with a thread yield between checks.
+	static constexpr size_t yield_count = 0;
+};
+
+/** Wait strategy which polls for work, then yields, then blocks.
+ *
+ * A worker polls TSpinCount times with a CPU pause between checks, then polls TYieldCount
+ * times while yielding the processor to other threads, and finally blocks. The yield phase
+ * extends the polling window without starving other threads on the same core.
+ *
+ * @tparam TSpinCount The number of times to poll with a CPU pause.
+ * @tparam TYieldCount The number of times to poll with a thread yield.
+ */
+template<const size_t TSpinCount = 1000, const size_t TYieldCount = 100>
+struct DispatchWaitSpinYield
+{
+	/// Number of times to poll for work with a CPU pause between checks.
+	static constexpr size_t spin_count = TSpinCount;
+	/// Number of times to poll for work with a thread yield between checks.
+	static constexpr size_t yield_count = TYieldCount;
+};
+
+/// Indicates whether the wait strategy polls for work before blocking.
+template<typename TWait>
+constexpr bool dispatch_wait_polls_v = (TWait::spin_count + TWait::yield_count) > 0;
+
+/// Hint to the processor that the caller is in a spin loop.
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/** Poll for a condition according to a wait strategy.
+ *
+ * The condition is checked without blocking. The caller blocks if this function returns false.
+ *
+ * @tparam TWait The wait strategy.
+ * @tparam TReady The condition type. Deduced by the compiler.
+ * @param ready Returns true once the wait is over. It is called without any locks held, so it
+ *	must only read atomic state.
+ * @returns true if the condition was met while polling, false if the caller should block.
+ */
+template<typename TWait, typename TReady>
+bool dispatch_poll(TReady&& ready) noexcept
+{
+	for(size_t i = 0; i < TWait::spin_count; i++)
+	{
+		if(ready())
+		{
+			return true;
+		}
+
+		cpu_relax();
+	}
+
+	for(size_t i = 0; i < TWait::yield_count; i++)
+	{
+		if(ready())
+		{
+			return true;
+		}
+
+		std::this_thread::yield();
+	}
+
+	return ready();
+}
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // DISPATCH_WAIT_HPP_
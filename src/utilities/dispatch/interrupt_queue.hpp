@@ -4,13 +4,18 @@
 #ifndef INTERRUPT_QUEUE_HPP_
 #define INTERRUPT_QUEUE_HPP_
 
+#include "dispatch_wait.hpp"
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <etl/function.h>
 #include <etl/queue.h>
 #include <etl/vector.h>
 #include <functional>
 #include <inplace_function/inplace_function.hpp>
 #include <interrupt_lock/interrupt_lock.hpp>
+#include <lock_free_queue/spsc_queue.hpp>
 #include <os.hpp>
 #include <rtos/event_flag.hpp>
 #include <thread>
@@ -25,6 +30,25 @@ namespace embutil
 using IRQBottomHalfOp_t = stdext::inplace_function<void(), 96>;
 using IRQDispatcherFunc_t = stdext::inplace_function<void(const IRQBottomHalfOp_t&)>;
 
+/// Coalesced bottom-half handler, which receives the number of interrupts it represents.
+using IRQCoalescedOp_t = stdext::inplace_function<void(uint32_t), 96>;
+
+/// Behavior of an InterruptQueue when an operation is dispatched while the queue is full.
+enum class InterruptQueueOverflow : uint8_t
+{
+	/// Trigger an assertion. The operation is discarded if assertions are disabled.
+	assert_full = 0,
+	/// Discard the new operation.
+	drop_newest,
+	/// Discard the oldest queued operation to make room for the new operation.
+	drop_oldest,
+	/// Discard the new operation, and call the overflow handler on the queue thread.
+	signal,
+};
+
+/// Overflow handler, which receives the total number of discarded operations.
+using IRQOverflowFunc_t = stdext::inplace_function<void(size_t)>;
+
 // TODO: update documentation (tparams, for instance)
 /** IRQ safe dispatch queue (For running application-level (bottom-half) interrupt handlers)
  *
@@ -43,18 +67,55 @@ using IRQDispatcherFunc_t = stdext::inplace_function<void(const IRQBottomHalfOp_
  * into TEnableOp. TDisableOp's return is used to restore the proper value
  * once interrupts are re-enabled.
  *
+ * Each time the queue thread wakes up, it moves every queued operation into a local batch while
+ * holding the lock once, and then runs the batch without the lock. A burst of interrupts is
+ * handled with a single wakeup. The batch storage doubles the memory used for operations.
+ *
+ * The behavior when the queue is full is selected with an InterruptQueueOverflow policy. Every
+ * discarded operation is counted, and the count is available through overflow_count().
+ *
  * @tparam TLockType The type of lock to use for protecting the queue. Must meet the requirements
  *	of a basic lockable type.
  * @tparam TSize The maximum number of operations to store in the queue.
+ * @tparam TWait The wait strategy used by the queue thread when the queue is empty. The default,
+ *	DispatchWaitBlock, waits on the event flag immediately. DispatchWaitSpin and
+ *	DispatchWaitSpinYield poll the queue first, which reduces the latency between an interrupt
+ *	and its bottom-half handler.
+ * @tparam TCoalesceSlots The number of interrupt sources which can have a coalesced operation
+ *	pending at the same time. Must be > 0 to use dispatch_coalesced().
  */
-template<typename TLockType, const size_t TSize = 32>
+template<typename TLockType, const size_t TSize = 32, typename TWait = DispatchWaitBlock,
+		 const size_t TCoalesceSlots = 0>
 class InterruptQueue
 {
+	/// Pending coalesced operation for a single interrupt source.
+	struct CoalesceSlot
+	{
+		/// The interrupt source.
+		uint32_t key = 0;
+		/// Number of interrupts since the operation was queued. 0 if the slot is unused.
+		uint32_t count = 0;
+		/// Sequence number of the queue entry which runs the operation.
+		uint32_t seq = 0;
+		/// The bottom-half handler.
+		IRQCoalescedOp_t op{};
+	};
+
 	static constexpr uint32_t WORK_READY_FLAG = (1U << 0U);
 	static constexpr uint32_t QUIT_FLAG = (1U << 1U);
 
   public:
-	explicit InterruptQueue() noexcept : flags_(os::Factory::createEventFlag())
+	/** Create an interrupt queue.
+	 *
+	 * @param overflow The policy applied when an operation is dispatched to a full queue.
+	 * @param overflow_handler Called on the queue thread after operations are discarded with the
+	 *	InterruptQueueOverflow::signal policy. Overflows which occur before the handler runs are
+	 *	reported with a single call.
+	 */
+	explicit InterruptQueue(InterruptQueueOverflow overflow = InterruptQueueOverflow::assert_full,
+							IRQOverflowFunc_t overflow_handler = nullptr) noexcept
+		: flags_(os::Factory::createEventFlag()), overflow_(overflow),
+		  overflow_handler_(std::move(overflow_handler))
 	{
 		// Initialize thread inside of the constructor body to prevent race conditions
 		// With irq_lock_ not being properly initialized
@@ -95,6 +156,8 @@ class InterruptQueue
 	/** Dispatch an operation to the thread via copy
 	 * Adds the operation to the queue
 	 *
+	 * If the queue is full, the overflow policy is applied.
+	 *
 	 * This function is marked noexcept because we want the program to terminate if an exception
 	 * results from this call. It's possible that pushing to the queue would trigger
 	 * an exception depending on the underlying type, for example.
@@ -102,26 +165,20 @@ class InterruptQueue
 	void dispatch(const IRQBottomHalfOp_t& input_op) noexcept
 	{
 		irq_lock_.lock();
+		bool queued = enqueue(input_op);
+		irq_lock_.unlock();
 
-		if(q_.size() < q_.capacity())
+		if(queued || signal_overflow_)
 		{
-			q_.push(input_op);
-
-			irq_lock_.unlock();
-
 			flags_->setFromISR(WORK_READY_FLAG);
 		}
-		else
-		{
-			irq_lock_.unlock();
-			// IRQ queue filled to capacity - increase queue size or investigate thread blockage
-			assert(0);
-		}
 	}
 
 	/** Dispatch an operation to the thread via move
 	 * Adds the operation to the queue
 	 *
+	 * If the queue is full, the overflow policy is applied.
+	 *
 	 * This function is marked noexcept because we want the program to terminate if an exception
 	 * results from this call. It's possible that pushing to the queue would trigger
 	 * an exception depending on the underlying type, for example.
@@ -129,20 +186,83 @@ class InterruptQueue
 	void dispatch(IRQBottomHalfOp_t&& input_op) noexcept
 	{
 		irq_lock_.lock();
+		bool queued = enqueue(std::move(input_op));
+		irq_lock_.unlock();
 
-		if(q_.size() < q_.capacity())
+		if(queued || signal_overflow_)
 		{
-			q_.push(std::move(input_op));
+			flags_->setFromISR(WORK_READY_FLAG);
+		}
+	}
 
-			irq_lock_.unlock();
+	/** Dispatch an operation, merging it with a pending operation from the same source
+	 *
+	 * If an operation for key has been queued but has not started yet, no new operation is queued.
+	 * Instead, the pending operation's count is incremented, and the handler receives the total
+	 * number of interrupts when it runs. This bounds the queue usage of a chatty interrupt source
+	 * to a single entry.
+	 *
+	 * @code
+	 * void gpio_isr()
+	 * {
+	 * 	irq_q.dispatch_coalesced(GPIO_IRQ, [](uint32_t edges) { handle_edges(edges); });
+	 * }
+	 * @endcode
+	 *
+	 * @note When an operation is merged, input_op is discarded and the pending handler is kept.
+	 * @note If the queue is full, the overflow policy is applied to the new queue entry.
+	 *
+	 * @param key Identifies the interrupt source, such as the IRQ number.
+	 * @param input_op The bottom-half handler.
+	 */
+	void dispatch_coalesced(uint32_t key, const IRQCoalescedOp_t& input_op) noexcept
+	{
+		static_assert(TCoalesceSlots > 0, "dispatch_coalesced() requires TCoalesceSlots > 0");
 
-			flags_->setFromISR(WORK_READY_FLAG);
+		CoalesceSlot* free_slot = nullptr;
+
+		irq_lock_.lock();
+
+		for(auto& slot : coalesce_slots_)
+		{
+			if(slot.count > 0 && slot.key == key)
+			{
+				slot.count++;
+				irq_lock_.unlock();
+				return;
+			}
+
+			if(slot.count == 0 && free_slot == nullptr)
+			{
+				free_slot = &slot;
+			}
 		}
-		else
+
+		// No free coalescing slot - increase TCoalesceSlots
+		assert(free_slot);
+
+		bool queued = false;
+
+		if(free_slot)
 		{
-			irq_lock_.unlock();
-			// IRQ queue filled to capacity - increase queue size or investigate thread blockage
-			assert(0);
+			// The slot is claimed after enqueue(), which may release slots with drop_oldest
+			auto seq = pushed_;
+			queued = enqueue([this, free_slot]() { run_coalesced(*free_slot); });
+
+			if(queued)
+			{
+				free_slot->key = key;
+				free_slot->count = 1;
+				free_slot->seq = seq;
+				free_slot->op = input_op;
+			}
+		}
+
+		irq_lock_.unlock();
+
+		if(queued || signal_overflow_)
+		{
+			flags_->setFromISR(WORK_READY_FLAG);
 		}
 	}
 
@@ -171,33 +291,166 @@ class InterruptQueue
 		return 1;
 	}
 
+	/// Return the number of operations which have been discarded because the queue was full
+	[[nodiscard]] auto overflow_count() const noexcept -> size_t
+	{
+		return overflows_.load(std::memory_order_relaxed);
+	}
+
+	/// Return the overflow policy
+	[[nodiscard]] auto overflow_policy() const noexcept -> InterruptQueueOverflow
+	{
+		return overflow_;
+	}
+
   private:
 	std::thread thread_{};
 	embvm::VirtualEventFlag* flags_{};
 	etl::queue<IRQBottomHalfOp_t, TSize> q_{};
 	TLockType irq_lock_;
+	/// Number of operations in the queue, readable without the lock (polling wait strategies only).
+	std::atomic<size_t> pending_ = 0;
+	/// Pending coalesced operations.
+	std::array<CoalesceSlot, TCoalesceSlots> coalesce_slots_{};
+	/// Operations moved out of the queue by the queue thread.
+	etl::vector<IRQBottomHalfOp_t, TSize> batch_{};
+	/// Sequence number of the next operation added to the queue.
+	uint32_t pushed_ = 0;
+	/// Sequence number of the operation at the front of the queue.
+	uint32_t popped_ = 0;
+	/// The policy applied when the queue is full.
+	const InterruptQueueOverflow overflow_;
+	/// Called on the queue thread after an overflow with the signal policy.
+	IRQOverflowFunc_t overflow_handler_;
+	/// Number of discarded operations.
+	std::atomic<size_t> overflows_ = 0;
+	/// Indicates that the overflow handler should be called.
+	std::atomic<bool> signal_overflow_ = false;
+
+	/** Add an operation to the queue, applying the overflow policy if the queue is full.
+	 *
+	 * @pre irq_lock_ is held.
+	 * @returns true if the operation was added.
+	 */
+	template<typename TOp>
+	auto enqueue(TOp&& op) noexcept -> bool
+	{
+		if(q_.size() == q_.capacity())
+		{
+			// Only called with the lock held, so a read-modify-write is not required
+			overflows_.store(overflows_.load(std::memory_order_relaxed) + 1,
+							 std::memory_order_relaxed);
+
+			switch(overflow_)
+			{
+				case InterruptQueueOverflow::drop_oldest:
+					drop_front();
+					break;
+				case InterruptQueueOverflow::signal:
+					signal_overflow_.store(true, std::memory_order_relaxed);
+					return false;
+				case InterruptQueueOverflow::drop_newest:
+					return false;
+				case InterruptQueueOverflow::assert_full:
+				default:
+					// IRQ queue filled to capacity - increase queue size or investigate thread
+					// blockage
+					assert(0);
+					return false;
+			}
+		}
+
+		q_.push(std::forward<TOp>(op));
+		pushed_++;
+
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			pending_.store(q_.size(), std::memory_order_relaxed);
+		}
+
+		return true;
+	}
+
+	/** Discard the operation at the front of the queue.
+	 *
+	 * If the operation runs a coalesced handler, the coalescing slot is released so that the
+	 * source can be queued again.
+	 *
+	 * @pre irq_lock_ is held, and the queue is not empty.
+	 */
+	void drop_front() noexcept
+	{
+		for(auto& slot : coalesce_slots_)
+		{
+			if(slot.count > 0 && slot.seq == popped_)
+			{
+				slot.op = nullptr;
+				slot.count = 0;
+			}
+		}
+
+		q_.pop();
+		popped_++;
+	}
 
-	/**
-	 * Convenience function which waits for the queue and pops off of it without requiring excessive
-	 * locks/unlocks
+	/** Run a coalesced operation on the queue thread.
 	 *
-	 * Using a reference parameter to receive the result is used to transfer ownership
-	 * out of the queue in order to avoid the exception safety issues of returning data
-	 * by-value: if the copy constructor of a by-value return throws, then the data
-	 * has been removed from the queue, but is lost, whereas with this approach, the
-	 * potentially problematic copy is performed prior to modifying the queue
-	 * (see Herb Sutter's Guru Of The Week #8 for a discussion of the issues).4
+	 * The slot is released before the handler runs, so interrupts which arrive while the handler
+	 * is running queue a new operation.
+	 */
+	void run_coalesced(CoalesceSlot& slot) noexcept
+	{
+		irq_lock_.lock();
+		auto op = std::move(slot.op);
+		auto count = slot.count;
+		slot.op = nullptr;
+		slot.count = 0;
+		irq_lock_.unlock();
+
+		op(count);
+	}
+
+	/** Wait for operations and move them from the queue into batch_.
 	 *
+	 * The lock is held once to take every operation which is in the queue.
 	 *
 	 * This function is marked noexcept because we want the program to terminate if an exception
 	 * results from this call.
 	 *
 	 * @returns false if the thread should exit, true otherwise
 	 */
-	auto wait_and_pop(IRQBottomHalfOp_t& input_op) noexcept -> bool
+	auto wait_and_drain() noexcept -> bool
 	{
-		while(q_.empty())
+		if constexpr(dispatch_wait_polls_v<TWait>)
 		{
+			dispatch_poll<TWait>([this] { return pending_.load(std::memory_order_relaxed) > 0; });
+		}
+
+		while(true)
+		{
+			irq_lock_.lock();
+
+			while(!q_.empty())
+			{
+				batch_.push_back(std::move(q_.front()));
+				q_.pop();
+				popped_++;
+			}
+
+			if constexpr(dispatch_wait_polls_v<TWait>)
+			{
+				pending_.store(0, std::memory_order_relaxed);
+			}
+
+			irq_lock_.unlock();
+
+			if(!batch_.empty() || signal_overflow_)
+			{
+				return true;
+			}
+
+			// The event flag stays set until we read it, so a dispatch after the queue was
+			// checked is not missed
 			auto flags = flags_->get(WORK_READY_FLAG | QUIT_FLAG);
 			bool quit = (flags & QUIT_FLAG) != 0U;
 
@@ -206,16 +459,193 @@ class InterruptQueue
 				return false;
 			}
 		}
+	}
 
-		std::lock_guard<TLockType> lock(irq_lock_);
-		input_op = std::move(q_.front());
-		q_.pop();
+	/** Thread handler for dispatch queue threads
+	 * Sleeps until there is an operation in the thread (or quit_ is set)
+	 * Processes operations from queue
+	 *
+	 * This function is marked noexcept because we want the program to terminate if an exception
+	 * results from this call.
+	 */
+	void dispatch_thread_handler() noexcept
+	{
+		while(wait_and_drain())
+		{
+			for(auto& op : batch_)
+			{
+				if(op)
+				{
+					op();
+				}
+			}
+
+			batch_.clear();
+
+			if(signal_overflow_.exchange(false) && overflow_handler_)
+			{
+				overflow_handler_(overflow_count());
+			}
+		};
+	}
+};
+
+/** IRQ safe dispatch queue for a single interrupt producer
+ *
+ * This queue has the same interface as InterruptQueue, but operations are stored in a wait-free
+ * SPSCQueue instead of a lock-protected queue. dispatch() does not mask interrupts, and the
+ * bottom-half thread never blocks the interrupt handler, which shortens both the ISR execution
+ * time and the window where interrupts are disabled.
+ *
+ * @code
+ * embutil::SPSCInterruptQueue<16> irq_q;
+ *
+ * void uart_rx_isr()
+ * {
+ * 	irq_q.dispatch(process_rx);
+ * }
+ * @endcode
+ *
+ * @note Only one context may call dispatch(). If operations are dispatched from multiple
+ *	interrupts which can preempt each other, or from both an interrupt and a thread, use
+ *	InterruptQueue instead.
+ *
+ * @tparam TSize The maximum number of operations to store in the queue.
+ * @tparam TWait The wait strategy used by the queue thread when the queue is empty.
+ */
+template<const size_t TSize = 32, typename TWait = DispatchWaitBlock>
+class SPSCInterruptQueue
+{
+	static constexpr uint32_t WORK_READY_FLAG = (1U << 0U);
+	static constexpr uint32_t QUIT_FLAG = (1U << 1U);
+
+  public:
+	explicit SPSCInterruptQueue() noexcept : flags_(os::Factory::createEventFlag())
+	{
+		// Initialize thread inside of the constructor body so the queue is constructed first
+		thread_ = std::thread(&SPSCInterruptQueue::dispatch_thread_handler, this);
+	}
+
+	/** Destroy an interupt queue and kill the thread
+	 *
+	 * This function is marked noexcept because we want the program to terminate if an exception
+	 * results from this call.
+	 */
+	~SPSCInterruptQueue() noexcept
+	{
+		// Signal to dispatch threads that it's time to wrap up
+		flags_->set(QUIT_FLAG);
+
+		if(thread_.joinable())
+		{
+			thread_.join();
+		}
+
+		os::Factory::destroy(flags_);
+		flags_ = nullptr;
+	}
+
+	/// Deleted copy constructor
+	SPSCInterruptQueue(const SPSCInterruptQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	auto operator=(const SPSCInterruptQueue&) -> const SPSCInterruptQueue& = delete;
+
+	/// Deleted move constructor
+	SPSCInterruptQueue(SPSCInterruptQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	auto operator=(SPSCInterruptQueue&&) -> SPSCInterruptQueue& = delete;
+
+	/** Dispatch an operation to the thread via copy
+	 * Adds the operation to the queue
+	 *
+	 * @pre Only one context calls dispatch().
+	 */
+	void dispatch(const IRQBottomHalfOp_t& input_op) noexcept
+	{
+		[[maybe_unused]] bool pushed = q_.push(input_op);
+
+		// IRQ queue filled to capacity - increase queue size or investigate thread blockage
+		assert(pushed);
+
+		flags_->setFromISR(WORK_READY_FLAG);
+	}
+
+	/** Dispatch an operation to the thread via move
+	 * Adds the operation to the queue
+	 *
+	 * @pre Only one context calls dispatch().
+	 */
+	void dispatch(IRQBottomHalfOp_t&& input_op) noexcept
+	{
+		[[maybe_unused]] bool pushed = q_.push(std::move(input_op));
+
+		// IRQ queue filled to capacity - increase queue size or investigate thread blockage
+		assert(pushed);
+
+		flags_->setFromISR(WORK_READY_FLAG);
+	}
+
+	auto getBoundDispatch() noexcept
+	{
+		return std::bind(static_cast<void (SPSCInterruptQueue::*)(const IRQBottomHalfOp_t&)>(
+							 &SPSCInterruptQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/// Return the current number of enqueued operations
+	[[nodiscard]] auto queue_size() const noexcept -> size_t
+	{
+		return q_.size();
+	}
+
+	/// Return the capacity of the queue
+	[[nodiscard]] constexpr auto capacity() const noexcept -> size_t
+	{
+		return q_.capacity();
+	}
+
+	/// Return the number of threads associated with the interrupt queue (always 1)
+	[[nodiscard]] constexpr auto thread_count() const noexcept -> size_t
+	{
+		return 1;
+	}
+
+  private:
+	std::thread thread_{};
+	embvm::VirtualEventFlag* flags_{};
+	SPSCQueue<IRQBottomHalfOp_t, TSize> q_{};
+
+	/** Wait for an operation and remove it from the queue.
+	 *
+	 * @returns false if the thread should exit, true otherwise
+	 */
+	auto wait_and_pop(IRQBottomHalfOp_t& input_op) noexcept -> bool
+	{
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			dispatch_poll<TWait>([this] { return !q_.empty(); });
+		}
+
+		// The event flag stays set until we read it, so a push between pop() and get() is
+		// not missed
+		while(!q_.pop(input_op))
+		{
+			auto flags = flags_->get(WORK_READY_FLAG | QUIT_FLAG);
+			bool quit = (flags & QUIT_FLAG) != 0U;
+
+			if(quit)
+			{
+				return false;
+			}
+		}
 
 		return true;
 	}
 
-	/** Thread handler for dispatch queue threads
-	 * Sleeps until there is an operation in the thread (or quit_ is set)
+	/** Thread handler for the bottom-half thread
+	 * Sleeps until there is an operation in the queue (or the quit flag is set)
 	 * Processes operations from queue
 	 *
 	 * This function is marked noexcept because we want the program to terminate if an exception
@@ -231,7 +661,242 @@ class InterruptQueue
 			{
 				current_op();
 			}
-		};
+		}
+	}
+};
+
+/** IRQ safe dispatch queue with a separate FIFO for each interrupt priority level
+ *
+ * InterruptQueue runs bottom halves in arrival order, so the bottom half of an urgent interrupt
+ * waits behind every slower bottom half that was queued before it. This queue keeps one FIFO per
+ * priority level, and the bottom-half thread always runs the oldest operation from the most
+ * urgent non-empty level. An urgent bottom half waits for at most the operation which is
+ * currently running.
+ *
+ * Level 0 is the most urgent level, matching the convention used by interrupt controllers such
+ * as the NVIC, where a lower priority value preempts a higher value. Operations within a level
+ * run in order.
+ *
+ * @code
+ * embutil::PriorityInterruptQueue<IRQLock, 4, 8> irq_q;
+ *
+ * void timer_isr()
+ * {
+ * 	// Uses the priority assigned to the interrupt by the interrupt manager
+ * 	irq_q.dispatch_irq<InterruptManager>(TIMER_IRQ, process_timer);
+ * }
+ *
+ * void i2c_isr()
+ * {
+ * 	irq_q.dispatch(3, process_i2c_completion);
+ * }
+ * @endcode
+ *
+ * To keep the latency bound, the bottom-half thread removes one operation per lock acquisition,
+ * rather than draining the queue in a batch as InterruptQueue does.
+ *
+ * @tparam TLockType The type of lock to use for protecting the queue. Must meet the requirements
+ *	of a basic lockable type.
+ * @tparam TLevels The number of priority levels. Must be > 0.
+ * @tparam TSize The maximum number of operations to store in each priority level.
+ * @tparam TWait The wait strategy used by the queue thread when the queue is empty.
+ */
+template<typename TLockType, const size_t TLevels, const size_t TSize = 8,
+		 typename TWait = DispatchWaitBlock>
+class PriorityInterruptQueue
+{
+	static_assert(TLevels > 0, "PriorityInterruptQueue requires TLevels > 0");
+
+	static constexpr uint32_t WORK_READY_FLAG = (1U << 0U);
+	static constexpr uint32_t QUIT_FLAG = (1U << 1U);
+
+  public:
+	explicit PriorityInterruptQueue() noexcept : flags_(os::Factory::createEventFlag())
+	{
+		// Initialize thread inside of the constructor body to prevent race conditions
+		// With irq_lock_ not being properly initialized
+		thread_ = std::thread(&PriorityInterruptQueue::dispatch_thread_handler, this);
+	}
+
+	/** Destroy an interupt queue and kill the thread
+	 *
+	 * This function is marked noexcept because we want the program to terminate if an exception
+	 * results from this call.
+	 */
+	~PriorityInterruptQueue() noexcept
+	{
+		// Signal to dispatch threads that it's time to wrap up
+		flags_->set(QUIT_FLAG);
+
+		if(thread_.joinable())
+		{
+			thread_.join();
+		}
+
+		os::Factory::destroy(flags_);
+		flags_ = nullptr;
+	}
+
+	/// Deleted copy constructor
+	PriorityInterruptQueue(const PriorityInterruptQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	auto operator=(const PriorityInterruptQueue&) -> const PriorityInterruptQueue& = delete;
+
+	/// Deleted move constructor
+	PriorityInterruptQueue(PriorityInterruptQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	auto operator=(PriorityInterruptQueue&&) -> PriorityInterruptQueue& = delete;
+
+	/** Dispatch an operation to the thread at a priority level
+	 *
+	 * @param level The priority level, where 0 is the most urgent. Levels >= TLevels are queued
+	 *	at the least urgent level.
+	 * @param input_op The bottom-half handler.
+	 */
+	void dispatch(size_t level, const IRQBottomHalfOp_t& input_op) noexcept
+	{
+		auto& q = levels_[clamp_level(level)];
+
+		irq_lock_.lock();
+
+		if(q.size() < q.capacity())
+		{
+			q.push(input_op);
+			pending_.store(pending_.load(std::memory_order_relaxed) + 1,
+						   std::memory_order_relaxed);
+
+			irq_lock_.unlock();
+
+			flags_->setFromISR(WORK_READY_FLAG);
+		}
+		else
+		{
+			irq_lock_.unlock();
+			// IRQ queue level filled to capacity - increase queue size or investigate thread
+			// blockage
+			assert(0);
+		}
+	}
+
+	/** Dispatch an operation at the priority assigned to an interrupt
+	 *
+	 * The level is TManager::priority(irq) >> TPriorityShift. Interrupt controllers often only
+	 * implement the upper bits of the priority field (e.g., values 0x00, 0x40, 0x80, 0xC0 on a
+	 * part with two priority bits), so TPriorityShift discards the unimplemented bits.
+	 *
+	 * @tparam TManager The interrupt manager, which provides a static priority(irq) function
+	 *	(e.g., an InterruptManagerBase-derived class).
+	 * @tparam TPriorityShift The number of low priority bits to discard.
+	 * @param irq The interrupt which is dispatching the operation.
+	 * @param input_op The bottom-half handler.
+	 */
+	template<typename TManager, unsigned TPriorityShift = 0, typename TIRQ>
+	void dispatch_irq(TIRQ irq, const IRQBottomHalfOp_t& input_op) noexcept
+	{
+		dispatch(static_cast<size_t>(TManager::priority(irq)) >> TPriorityShift, input_op);
+	}
+
+	/// Return the current number of enqueued operations in all priority levels
+	[[nodiscard]] auto queue_size() const noexcept -> size_t
+	{
+		return pending_.load(std::memory_order_relaxed);
+	}
+
+	/// Return the capacity of each priority level
+	[[nodiscard]] constexpr auto capacity() const noexcept -> size_t
+	{
+		return TSize;
+	}
+
+	/// Return the number of priority levels
+	[[nodiscard]] constexpr auto levels() const noexcept -> size_t
+	{
+		return TLevels;
+	}
+
+	/// Return the number of threads associated with the interrupt queue (always 1)
+	[[nodiscard]] constexpr auto thread_count() const noexcept -> size_t
+	{
+		return 1;
+	}
+
+  private:
+	std::thread thread_{};
+	embvm::VirtualEventFlag* flags_{};
+	std::array<etl::queue<IRQBottomHalfOp_t, TSize>, TLevels> levels_{};
+	TLockType irq_lock_;
+	/// Number of operations in all levels, readable without the lock.
+	std::atomic<size_t> pending_ = 0;
+
+	/// Map a requested level to a valid level.
+	static constexpr auto clamp_level(size_t level) noexcept -> size_t
+	{
+		return (level < TLevels) ? level : (TLevels - 1);
+	}
+
+	/** Wait for an operation and remove it from the most urgent non-empty level.
+	 *
+	 * @returns false if the thread should exit, true otherwise
+	 */
+	auto wait_and_pop(IRQBottomHalfOp_t& input_op) noexcept -> bool
+	{
+		if constexpr(dispatch_wait_polls_v<TWait>)
+		{
+			dispatch_poll<TWait>([this] { return pending_.load(std::memory_order_relaxed) > 0; });
+		}
+
+		while(true)
+		{
+			irq_lock_.lock();
+
+			for(auto& q : levels_)
+			{
+				if(!q.empty())
+				{
+					input_op = std::move(q.front());
+					q.pop();
+					pending_.store(pending_.load(std::memory_order_relaxed) - 1,
+								   std::memory_order_relaxed);
+					irq_lock_.unlock();
+
+					return true;
+				}
+			}
+
+			irq_lock_.unlock();
+
+			// The event flag stays set until we read it, so a dispatch after the levels were
+			// checked is not missed
+			auto flags = flags_->get(WORK_READY_FLAG | QUIT_FLAG);
+			bool quit = (flags & QUIT_FLAG) != 0U;
+
+			if(quit)
+			{
+				return false;
+			}
+		}
+	}
+
+	/** Thread handler for the bottom-half thread
+	 * Sleeps until there is an operation in the queue (or the quit flag is set)
+	 * Processes operations from queue, most urgent level first
+	 *
+	 * This function is marked noexcept because we want the program to terminate if an exception
+	 * results from this call.
+	 */
+	void dispatch_thread_handler() noexcept
+	{
+		IRQBottomHalfOp_t current_op{};
+
+		while(wait_and_pop(current_op))
+		{
+			if(current_op)
+			{
+				current_op();
+			}
+		}
 	}
 };
 
@@ -3,7 +3,9 @@
 
 #include "dispatch.hpp"
 #include "interrupt_queue.hpp"
+#include <array>
 #include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
 #include <cstdint>
@@ -162,3 +164,417 @@ TEST_CASE("Add multiple operations to queue, all run", "[utility/interrupt_queue
 
 	CHECK(qsize == functions_dispatched);
 }
+
+TEST_CASE("Interrupt queue with polling wait strategy runs operations",
+		  "[utility/interrupt_queue]")
+{
+	const size_t qsize = 10;
+	InterruptQueue<IRQLock, qsize, DispatchWaitSpinYield<>> q;
+	functions_dispatched = 0;
+	uint8_t tries = 0;
+
+	for(size_t i = 0; i < qsize; i++)
+	{
+		q.dispatch(dispatch_check);
+	}
+
+	do
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		tries++;
+	} while(q.queue_size() > 0 && tries < RETRIES_MAX);
+
+	CHECK(qsize == functions_dispatched);
+}
+
+TEST_CASE("Coalesced interrupt operations are merged per source", "[utility/interrupt_queue]")
+{
+	InterruptQueue<IRQLock, 10, DispatchWaitBlock, 2> q;
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	std::atomic<uint32_t> count_a = 0;
+	std::atomic<uint32_t> count_b = 0;
+	std::atomic<int> calls = 0;
+
+	// Hold the queue thread so the coalesced operations stay pending
+	q.dispatch([&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	for(int i = 0; i < 100; i++)
+	{
+		q.dispatch_coalesced(1, [&](uint32_t count) {
+			count_a += count;
+			calls++;
+		});
+
+		if(i % 2)
+		{
+			q.dispatch_coalesced(2, [&](uint32_t count) {
+				count_b += count;
+				calls++;
+			});
+		}
+	}
+
+	CHECK(2 == q.queue_size());
+
+	release = true;
+
+	while(calls < 2)
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(100 == count_a);
+	CHECK(50 == count_b);
+
+	// The source can be queued again once its handler has started
+	q.dispatch_coalesced(1, [&](uint32_t count) {
+		count_a += count;
+		calls++;
+	});
+
+	while(calls < 3)
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(101 == count_a);
+}
+
+TEST_CASE("Interrupt queue overflow policies", "[utility/interrupt_queue]")
+{
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	std::atomic<uint32_t> ran_mask = 0;
+	std::atomic<int> ran = 0;
+
+	auto blocker = [&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	};
+
+	// Hold the queue thread, then dispatch six operations into a four-entry queue
+	auto fill = [&](auto& q) {
+		q.dispatch(blocker);
+
+		while(!started)
+		{
+			std::this_thread::yield();
+		}
+
+		for(uint32_t i = 0; i < 6; i++)
+		{
+			q.dispatch([&, i] {
+				ran_mask |= (1U << i);
+				ran++;
+			});
+		}
+	};
+
+	auto finish = [&](auto& q) {
+		release = true;
+
+		while(ran < 4)
+		{
+			std::this_thread::yield();
+		}
+
+		CHECK(2 == q.overflow_count());
+	};
+
+	SECTION("Drop newest keeps the first operations")
+	{
+		InterruptQueue<IRQLock, 4> q(InterruptQueueOverflow::drop_newest);
+		fill(q);
+		CHECK(4 == q.queue_size());
+		finish(q);
+		CHECK(0x0FU == ran_mask);
+	}
+
+	SECTION("Drop oldest keeps the latest operations")
+	{
+		InterruptQueue<IRQLock, 4> q(InterruptQueueOverflow::drop_oldest);
+		fill(q);
+		CHECK(4 == q.queue_size());
+		finish(q);
+		CHECK(0x3CU == ran_mask);
+	}
+
+	SECTION("Signal calls the overflow handler on the queue thread")
+	{
+		std::atomic<size_t> reported = 0;
+		std::atomic<int> handler_calls = 0;
+
+		InterruptQueue<IRQLock, 4> q(InterruptQueueOverflow::signal, [&](size_t overflows) {
+			reported = overflows;
+			handler_calls++;
+		});
+		fill(q);
+		finish(q);
+
+		while(handler_calls == 0)
+		{
+			std::this_thread::yield();
+		}
+
+		CHECK(0x0FU == ran_mask);
+		CHECK(2 == reported);
+		CHECK(1 == handler_calls);
+	}
+}
+
+TEST_CASE("Dropping the oldest operation releases its coalescing slot", "[utility/interrupt_queue]")
+{
+	InterruptQueue<IRQLock, 2, DispatchWaitBlock, 1> q(InterruptQueueOverflow::drop_oldest);
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	std::atomic<uint32_t> edges = 0;
+	std::atomic<int> ran = 0;
+
+	q.dispatch([&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	// The coalesced operation is at the front of the queue when it overflows
+	q.dispatch_coalesced(1, [&](uint32_t count) { edges += count; });
+	q.dispatch_coalesced(1, [&](uint32_t count) { edges += count; });
+	q.dispatch([&] { ran++; });
+	q.dispatch([&] { ran++; });
+	CHECK(1 == q.overflow_count());
+
+	// The source is no longer pending, so the slot must be available again
+	q.dispatch_coalesced(1, [&](uint32_t count) {
+		edges += count;
+		ran++;
+	});
+	CHECK(2 == q.overflow_count());
+
+	release = true;
+
+	while(ran < 2)
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(1 == edges);
+}
+
+TEST_CASE("Interrupt queue drains a full queue after one wakeup", "[utility/interrupt_queue]")
+{
+	const size_t qsize = 16;
+	InterruptQueue<IRQLock, qsize> q;
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	std::atomic<size_t> ran = 0;
+
+	q.dispatch([&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	for(size_t i = 0; i < qsize; i++)
+	{
+		q.dispatch([&] { ran++; });
+	}
+
+	CHECK(qsize == q.queue_size());
+
+	release = true;
+
+	while(ran < qsize)
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(0 == q.overflow_count());
+}
+
+TEST_CASE("SPSC interrupt queue runs operations in order", "[utility/interrupt_queue/spsc]")
+{
+	const size_t qsize = 10;
+	SPSCInterruptQueue<qsize> q;
+	std::atomic<int> last = -1;
+	std::atomic<bool> in_order = true;
+
+	CHECK(qsize == q.capacity());
+	CHECK(1 == q.thread_count());
+
+	// Dispatch from a separate context, standing in for the interrupt handler
+	std::thread producer([&] {
+		for(int i = 0; i < 1000; i++)
+		{
+			while(q.queue_size() == q.capacity())
+			{
+				std::this_thread::yield();
+			}
+
+			q.dispatch([&, i] {
+				if(last + 1 != i)
+				{
+					in_order = false;
+				}
+
+				last = i;
+			});
+		}
+	});
+
+	producer.join();
+
+	while(last < 999)
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(in_order);
+	CHECK(0 == q.queue_size());
+}
+
+TEST_CASE("Priority interrupt queue runs the most urgent level first",
+		  "[utility/interrupt_queue/priority]")
+{
+	struct TestInterruptManager
+	{
+		static auto priority(int irq) noexcept -> uint8_t
+		{
+			// Two implemented priority bits, stored in the upper bits of the field
+			return (irq == 0) ? 0x00 : 0xC0;
+		}
+	};
+
+	PriorityInterruptQueue<IRQLock, 4, 8> q;
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	std::atomic<int> ran = 0;
+	std::array<int, 6> order{};
+
+	CHECK(4 == q.levels());
+	CHECK(8 == q.capacity());
+
+	q.dispatch(3, [&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	auto record = [&](int id) { return [&, id] { order[ran++] = id; }; };
+
+	q.dispatch_irq<TestInterruptManager, 6>(1, record(30));
+	q.dispatch(2, record(20));
+	q.dispatch(100, record(31));
+	q.dispatch(1, record(10));
+	q.dispatch_irq<TestInterruptManager, 6>(0, record(0));
+	q.dispatch(0, record(1));
+
+	CHECK(6 == q.queue_size());
+
+	release = true;
+
+	while(ran < 6)
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(std::array<int, 6>{0, 1, 10, 20, 30, 31} == order);
+}
+
+TEST_CASE("Interrupt queue wakeup latency benchmark", "[utility/interrupt_queue][!benchmark]")
+{
+	auto round_trip = [](auto& q) {
+		int expected = functions_dispatched + 1;
+		q.dispatch(dispatch_check);
+
+		while(functions_dispatched < expected)
+		{
+			std::this_thread::yield();
+		}
+	};
+
+	InterruptQueue<IRQLock, 10> block_q;
+	InterruptQueue<IRQLock, 10, DispatchWaitSpin<>> spin_q;
+	InterruptQueue<IRQLock, 10, DispatchWaitSpinYield<>> spin_yield_q;
+
+	BENCHMARK("Block")
+	{
+		round_trip(block_q);
+	};
+
+	BENCHMARK("Spin")
+	{
+		round_trip(spin_q);
+	};
+
+	BENCHMARK("Spin, yield")
+	{
+		round_trip(spin_yield_q);
+	};
+}
+
+TEST_CASE("Interrupt queue dispatch benchmark", "[utility/interrupt_queue][!benchmark]")
+{
+	// Measures the time spent in dispatch(), which runs in the interrupt handler
+	auto dispatch_burst = [](auto& q) {
+		int expected = functions_dispatched + 8;
+
+		for(int i = 0; i < 8; i++)
+		{
+			q.dispatch(dispatch_check);
+		}
+
+		while(functions_dispatched < expected)
+		{
+			std::this_thread::yield();
+		}
+	};
+
+	InterruptQueue<IRQLock, 16> locked_q;
+	SPSCInterruptQueue<16> spsc_q;
+
+	BENCHMARK("Locked queue")
+	{
+		dispatch_burst(locked_q);
+	};
+
+	BENCHMARK("SPSC queue")
+	{
+		dispatch_burst(spsc_q);
+	};
+}
@@ -0,0 +1,299 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef LOCK_FREE_DISPATCH_HPP_
+#define LOCK_FREE_DISPATCH_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <etl/vector.h>
+#include <functional>
+#include <inplace_function/inplace_function.hpp>
+#include <lock_free_queue/mpmc_queue.hpp>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Static dispatch queue backed by a lock-free ring.
+ *
+ * This queue provides the same interface as `StaticDispatchQueue`, but operations are stored in
+ * an embutil::MPMCQueue instead of a mutex-protected StaticFunctionQueue. Producers never take a
+ * lock on the dispatch() path unless a worker thread is parked, and worker threads only take the
+ * lock to park once the ring is empty.
+ *
+ * Use this queue when many producers dispatch to the same queue and contention on the queue lock
+ * becomes a bottleneck. Because each ring slot holds a TFunc by value, size TFunc for the largest
+ * functor you will dispatch.
+ *
+ * @code
+ * embutil::LockFreeDispatchQueue<128, 4> q("Worker Queue", 4);
+ * q.dispatch([] { printf("Hello from a lambda!\n"); });
+ * @endcode
+ *
+ * The queue can be used with `embvm::PlatformDispatcher`:
+ *
+ * @code
+ * using PlatformDispatchQueue = embutil::LockFreeDispatchQueue<128, 2>;
+ * @endcode
+ *
+ * Dispatch queues cannot be copied or moved.
+ *
+ * @tparam TSize The maximum number of operations which can be enqueued. TSize must be > 0.
+ * @tparam TThreadCount The maximum number of threads to use with the dispatch queue.
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the lock which protects parking. Can be overriden if a custom
+ *	mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TSize, const size_t TThreadCount = 1,
+		 typename TFunc = stdext::inplace_function<void()>, typename TLock = std::mutex,
+		 typename TCond = std::condition_variable>
+class LockFreeDispatchQueue
+{
+	static_assert(TSize > 0, "LockFreeDispatchQueue requires static memory: TSize must be > 0");
+
+  public:
+	/// Public alias for the dispatch functor type.
+	using DispatchFunc_t = TFunc;
+
+	/** Create an unnamed dispatch queue.
+	 *
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit LockFreeDispatchQueue(size_t thread_count = 1) noexcept
+		: LockFreeDispatchQueue(std::string_view("GenericDispatchQueue"), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a C-string name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit LockFreeDispatchQueue(const char* name, size_t thread_count = 1) noexcept
+		: LockFreeDispatchQueue(std::string_view(name), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a std::string name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * 	@note A std::string_view is stored, so the original std::string must remain valid.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit LockFreeDispatchQueue(const std::string& name, size_t thread_count = 1) noexcept
+		: LockFreeDispatchQueue(std::string_view(name), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a std::string_view name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit LockFreeDispatchQueue(const std::string_view name, size_t thread_count = 1) noexcept
+		: name_(name)
+	{
+		assert(thread_count <= TThreadCount && "thread_count cannot exceed TThreadCount");
+
+		for(size_t i = 0; i < thread_count; i++)
+		{
+			threads_.emplace_back(&LockFreeDispatchQueue::dispatch_thread_handler, this);
+		}
+	}
+
+	/** Default destructor.
+	 *
+	 * The destructor notifies dispatch threads that it is time to quit and waits for them to exit.
+	 * Operations which have not started yet are discarded.
+	 */
+	~LockFreeDispatchQueue() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		quit_ = true;
+		lock.unlock();
+		cv_.notify_all();
+
+		for(auto& t : threads_)
+		{
+			if(t.joinable())
+			{
+				t.join();
+			}
+		}
+	}
+
+	/// Deleted copy constructor
+	LockFreeDispatchQueue(const LockFreeDispatchQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	const LockFreeDispatchQueue& operator=(const LockFreeDispatchQueue&) = delete;
+
+	/// Deleted move constructor
+	LockFreeDispatchQueue(LockFreeDispatchQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	LockFreeDispatchQueue& operator=(LockFreeDispatchQueue&&) = delete;
+
+	/** Dispatch an operation
+	 *
+	 * The operation is pushed into the ring without taking a lock. The queue lock is only touched
+	 * when at least one worker thread is parked and must be woken up.
+	 *
+	 * @param op The operation to dispatch to a worker thread.
+	 */
+	void dispatch(const TFunc& op) noexcept
+	{
+		enqueue(op);
+	}
+
+	/// @overload void dispatch(const TFunc& op)
+	void dispatch(TFunc&& op) noexcept
+	{
+		enqueue(std::move(op));
+	}
+
+	/** Get a std::bind object for the instance's dispatch(const&) function.
+	 *
+	 * @returns std::bind construct which will map to the the dispatch(const&) function
+	 *	for this queue instance.
+	 */
+	auto getBoundDispatch() noexcept
+	{
+		return std::bind(static_cast<void (LockFreeDispatchQueue::*)(const DispatchFunc_t&)>(
+							 &LockFreeDispatchQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/** Get a std::bind object for the instance's dispatch(&&) function.
+	 *
+	 * @returns std::bind construct which will map to the the dispatch(&&) function
+	 *	for this queue instance.
+	 */
+	auto getBoundMoveDispatch() noexcept
+	{
+		return std::bind(static_cast<void (LockFreeDispatchQueue::*)(DispatchFunc_t &&)>(
+							 &LockFreeDispatchQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/** Get the current size of the operation queue.
+	 *
+	 * @returns the current number of enqueued operations.
+	 */
+	size_t queue_size() const noexcept
+	{
+		return pending_.load();
+	}
+
+	/** Get the capacity of the operation queue.
+	 *
+	 * @returns the capacity of the queue
+	 */
+	constexpr size_t capacity() const noexcept
+	{
+		return q_.capacity();
+	}
+
+	/** Get the number of threads used by this dispatch queue.
+	 *
+	 * @return the number of threads associated with this dispatch queue
+	 */
+	constexpr size_t thread_count() const noexcept
+	{
+		return threads_.size();
+	}
+
+  private:
+	/** Push an operation and wake a parked worker if needed.
+	 *
+	 * pending_ is incremented before the push, and sleepers_ is checked after it. Workers
+	 * increment sleepers_ before checking pending_. Both use sequentially-consistent ordering, so
+	 * either the producer sees the parked worker, or the worker sees the new operation.
+	 */
+	template<typename TOp>
+	void enqueue(TOp&& op) noexcept
+	{
+		pending_++;
+
+		if(!q_.push(std::forward<TOp>(op)))
+		{
+			pending_--;
+			assert(0 && "Max dispatch operations reached - increase LockFreeDispatchQueue::TSize");
+			return;
+		}
+
+		if(sleepers_.load() > 0)
+		{
+			// Taking the lock ensures a worker which is about to park is already waiting
+			std::unique_lock<TLock> lock(lock_);
+			lock.unlock();
+			cv_.notify_one();
+		}
+	}
+
+	/** Worker thread handler.
+	 *
+	 * - Threads pop and run operations from the ring until it is empty
+	 * - When the ring is empty, the worker parks on the condition variable until work is
+	 *	available (or quit_ is set)
+	 */
+	void dispatch_thread_handler() noexcept
+	{
+		TFunc op;
+
+		while(!quit_)
+		{
+			if(q_.pop(op))
+			{
+				pending_--;
+				op();
+				op = nullptr;
+				continue;
+			}
+
+			std::unique_lock<TLock> lock(lock_);
+			sleepers_++;
+			cv_.wait(lock, [this] { return (quit_ || pending_.load() > 0); });
+			sleepers_--;
+		}
+	}
+
+  private:
+	/// Name of the dispatch queue.
+	const std::string_view name_;
+	/// Lock used only for parking and waking worker threads.
+	TLock lock_;
+	/// Vector of threads which handle dispatch operations.
+	etl::vector<std::thread, TThreadCount> threads_;
+	/// The lock-free operation queue.
+	embutil::MPMCQueue<TFunc, TSize> q_;
+	/// The condition variable which is used to wake parked dispatch threads.
+	TCond cv_;
+	/// Number of operations which have been dispatched but not yet started.
+	std::atomic<size_t> pending_ = 0;
+	/// Number of worker threads which are parked (or about to park).
+	std::atomic<size_t> sleepers_ = 0;
+	/// Flag used to signal to threads that it is time to shutdown the queue.
+	std::atomic<bool> quit_ = false;
+};
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // LOCK_FREE_DISPATCH_HPP_
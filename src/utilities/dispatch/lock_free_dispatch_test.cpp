@@ -0,0 +1,136 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "lock_free_dispatch.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+
+#pragma mark - Helpers -
+
+static std::atomic<size_t> flag = 0;
+
+static void test_flag(void)
+{
+	flag = 1;
+}
+
+static void test_count(void)
+{
+	flag++;
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create lock-free dispatch queue", "[utility/dispatch/lock_free]")
+{
+	const size_t qsize = 10;
+	const size_t num_threads = 2;
+	embutil::LockFreeDispatchQueue<qsize, num_threads> q("TestQueue", num_threads);
+
+	SECTION("Queue starts empty")
+	{
+		CHECK(0 == q.queue_size());
+	}
+
+	SECTION("Queue Capacity non-zero")
+	{
+		CHECK(10 == q.capacity());
+	}
+
+	SECTION("Queue threads matches definition")
+	{
+		CHECK(num_threads == q.thread_count());
+	}
+}
+
+TEST_CASE("Lock-free dispatch function adds to queue", "[utility/dispatch/lock_free]")
+{
+	embutil::LockFreeDispatchQueue<10> q("TestQueue", 0);
+	q.dispatch(test_flag);
+
+	CHECK(1 == q.queue_size());
+}
+
+TEST_CASE("Dispatch lambda runs after added to lock-free queue", "[utility/dispatch/lock_free]")
+{
+	flag = 0;
+	embutil::LockFreeDispatchQueue<128> q("TestQueue");
+
+	q.dispatch([] { flag = 2; });
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(flag == 2);
+}
+
+TEST_CASE("Bound dispatch forwards to lock-free queue", "[utility/dispatch/lock_free]")
+{
+	flag = 0;
+	embutil::LockFreeDispatchQueue<128> q("TestQueue");
+	auto d = q.getBoundDispatch();
+
+	d(test_flag);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(flag == 1);
+}
+
+TEST_CASE("Fill lock-free dispatch queue then empty", "[utility/dispatch/lock_free]")
+{
+	const size_t qsize = 128;
+	const size_t num_threads = 4;
+	flag = 0;
+	embutil::LockFreeDispatchQueue<qsize, num_threads> q("TestQueue", num_threads);
+
+	for(size_t i = 0; i < q.capacity(); i++)
+	{
+		q.dispatch(test_count);
+	}
+
+	for(int tries = 0; tries < 100 && flag < q.capacity(); tries++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	CHECK(flag == q.capacity());
+}
+
+TEST_CASE("Multiple producers dispatch to lock-free queue", "[utility/dispatch/lock_free]")
+{
+	const size_t num_producers = 4;
+	const size_t ops_per_producer = 1000;
+	flag = 0;
+	embutil::LockFreeDispatchQueue<64, 2> q("TestQueue", 2);
+	std::thread producers[num_producers];
+
+	for(auto& p : producers)
+	{
+		p = std::thread([&q] {
+			for(size_t i = 0; i < ops_per_producer; i++)
+			{
+				// Back off while the ring is full
+				while(q.queue_size() >= q.capacity() - num_producers)
+				{
+					std::this_thread::yield();
+				}
+
+				q.dispatch(test_count);
+			}
+		});
+	}
+
+	for(auto& p : producers)
+	{
+		p.join();
+	}
+
+	for(int tries = 0; tries < 100 && flag < num_producers * ops_per_producer; tries++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	CHECK(flag == num_producers * ops_per_producer);
+}
@@ -0,0 +1,493 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef PRIORITY_DISPATCH_HPP_
+#define PRIORITY_DISPATCH_HPP_
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <etl/vector.h>
+#include <function_queue/function_queue.hpp>
+#include <functional>
+#include <inplace_function/inplace_function.hpp>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Dispatch queue with multiple priority levels.
+ *
+ * Operations are stored in one FIFO per priority level. Worker threads always run the oldest
+ * operation from the highest-priority non-empty level, so a burst of low-priority work cannot
+ * delay latency-critical callbacks such as timer expirations or bus completions.
+ *
+ * Priority 0 is the highest priority, and `TPriorityLevels - 1` is the lowest. Operations
+ * dispatched without a priority are placed at the lowest level, so the queue can be used as a
+ * drop-in replacement for DispatchQueue_Base (e.g., with `embvm::PlatformDispatcher`).
+ *
+ * @code
+ * embutil::StaticPriorityDispatchQueue<32, 1, 3> q("Prioritized Queue");
+ * q.dispatch(flush_logs, 2);
+ * q.dispatch(handle_timer_expiration, 0);
+ * @endcode
+ *
+ * # Aging
+ *
+ * Strict priority can starve lower levels under sustained high-priority load. When TAgingLimit is
+ * non-zero, every time a non-empty level is passed over in favor of a higher level, its skip
+ * count is incremented. Once the count reaches TAgingLimit, the next operation from that level is
+ * run and the count is reset. This bounds the delay of low-priority work to TAgingLimit
+ * higher-priority operations.
+ *
+ * Dispatch queues cannot be copied or moved.
+ *
+ * @tparam TSize The size of the storage queue for each priority level. When TSize is 0, dynamic
+ *	memory allocation will be used. Otherwise static memory types are used and the maximum number
+ *	of operations per priority level is limited to TSize.
+ * @tparam TThreadCount The number of threads to use with the dispatch queue.
+ * @tparam TPriorityLevels The number of priority levels. Must be > 0.
+ * @tparam TAgingLimit The number of times a non-empty level can be passed over before it is
+ *	serviced. 0 disables aging (strict priority).
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TSize, const size_t TThreadCount, const size_t TPriorityLevels,
+		 const size_t TAgingLimit = 0, typename TFunc = stdext::inplace_function<void()>,
+		 typename TLock = std::mutex, typename TCond = std::condition_variable>
+class PriorityDispatchQueue
+{
+	static_assert(TPriorityLevels > 0, "PriorityDispatchQueue requires at least one level");
+
+	/// Type definition for the thread storage vector.
+	/// If TSize is 0, std::vector will be used (dynamic memory mode). Otherwise an etl::vector
+	/// of size TThreadCount is used.
+	using TVecType = typename std::conditional<(TSize == 0), std::vector<std::thread>,
+											   etl::vector<std::thread, TThreadCount>>::type;
+
+	/// Type definition for a single priority level's operation queue.
+	/// If TSize is 0, std::queue will be used (dynamic memory mode). Otherwise a
+	/// StaticFunctionQueue of size TSize is used.
+	using TQueueType = typename std::conditional<(TSize == 0), std::queue<TFunc>,
+												 embutil::StaticFunctionQueue<TSize>>::type;
+
+  public:
+	/// Public alias for the dispatch functor type.
+	using DispatchFunc_t = TFunc;
+
+	/// The priority level used by dispatch() calls which do not specify a priority.
+	static constexpr size_t DefaultPriority = TPriorityLevels - 1;
+
+	/** Create an unnamed dispatch queue.
+	 *
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit PriorityDispatchQueue(size_t thread_count = 1) noexcept
+		: PriorityDispatchQueue(std::string_view("GenericDispatchQueue"), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a C-string name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit PriorityDispatchQueue(const char* name, size_t thread_count = 1) noexcept
+		: PriorityDispatchQueue(std::string_view(name), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a std::string name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * 	@note A std::string_view is stored, so the original std::string must remain valid.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit PriorityDispatchQueue(const std::string& name, size_t thread_count = 1) noexcept
+		: PriorityDispatchQueue(std::string_view(name), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a std::string_view name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit PriorityDispatchQueue(const std::string_view name, size_t thread_count = 1) noexcept
+		: name_(name)
+	{
+		if constexpr(TSize == 0)
+		{
+			threads_.reserve(thread_count);
+		}
+		else
+		{
+			assert(thread_count <= TThreadCount && "thread_count cannot exceed TThreadCount");
+		}
+
+		for(size_t i = 0; i < thread_count; i++)
+		{
+			threads_.emplace_back(&PriorityDispatchQueue::dispatch_thread_handler, this);
+		}
+	}
+
+	/** Default destructor.
+	 *
+	 * The destructor notifies dispatch threads that it is time to quit. We must wait for threads
+	 * to exit before destroying the class to prevent race conditions and memory faults.
+	 */
+	~PriorityDispatchQueue() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		quit_ = true;
+		lock.unlock();
+		cv_.notify_all();
+
+		for(auto& t : threads_)
+		{
+			if(t.joinable())
+			{
+				t.join();
+			}
+		}
+	}
+
+	/// Deleted copy constructor
+	PriorityDispatchQueue(const PriorityDispatchQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	const PriorityDispatchQueue& operator=(const PriorityDispatchQueue&) = delete;
+
+	/// Deleted move constructor
+	PriorityDispatchQueue(PriorityDispatchQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	PriorityDispatchQueue& operator=(PriorityDispatchQueue&&) = delete;
+
+	/** Dispatch an operation at a specific priority
+	 *
+	 * @param op The operation to dispatch to a worker thread.
+	 * @param priority The priority level for the operation. 0 is the highest priority.
+	 *	Must be less than TPriorityLevels.
+	 */
+	void dispatch(const TFunc& op, size_t priority) noexcept
+	{
+		assert(priority < TPriorityLevels && "Invalid dispatch priority");
+
+		std::unique_lock<TLock> lock(lock_);
+		check_capacity(priority);
+		levels_[priority].push(op);
+		count_++;
+
+		// Manual unlocking is done before notifying, to avoid waking up
+		// the waiting thread only to block again (see notify_one for details)
+		lock.unlock();
+		cv_.notify_one();
+	}
+
+	/// @overload void dispatch(const TFunc& op, size_t priority)
+	void dispatch(TFunc&& op, size_t priority) noexcept
+	{
+		assert(priority < TPriorityLevels && "Invalid dispatch priority");
+
+		std::unique_lock<TLock> lock(lock_);
+		check_capacity(priority);
+		levels_[priority].push(std::move(op));
+		count_++;
+
+		lock.unlock();
+		cv_.notify_one();
+	}
+
+	/** Dispatch an operation at the default (lowest) priority
+	 *
+	 * @param op The operation to dispatch to a worker thread.
+	 */
+	void dispatch(const TFunc& op) noexcept
+	{
+		dispatch(op, DefaultPriority);
+	}
+
+	/// @overload void dispatch(const TFunc& op)
+	void dispatch(TFunc&& op) noexcept
+	{
+		dispatch(std::move(op), DefaultPriority);
+	}
+
+	/** Get a std::bind object for the instance's dispatch(const&) function.
+	 *
+	 * Operations dispatched through this object use the default priority.
+	 *
+	 * @returns std::bind construct which will map to the the dispatch(const&) function
+	 *	for this queue instance.
+	 */
+	auto getBoundDispatch() noexcept
+	{
+		return std::bind(static_cast<void (PriorityDispatchQueue::*)(const DispatchFunc_t&)>(
+							 &PriorityDispatchQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/** Get a std::bind object for the instance's dispatch(&&) function.
+	 *
+	 * Operations dispatched through this object use the default priority.
+	 *
+	 * @returns std::bind construct which will map to the the dispatch(&&) function
+	 *	for this queue instance.
+	 */
+	auto getBoundMoveDispatch() noexcept
+	{
+		return std::bind(static_cast<void (PriorityDispatchQueue::*)(DispatchFunc_t &&)>(
+							 &PriorityDispatchQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/** Get a std::bind object which dispatches at a fixed priority.
+	 *
+	 * This is useful for handing a prioritized dispatcher to another component, such as
+	 * the embvm::TimerManager:
+	 *
+	 * @code
+	 * embvm::TimerManager tm(timer, q.getBoundDispatch(0));
+	 * @endcode
+	 *
+	 * @param priority The priority level for dispatched operations.
+	 * @returns std::bind construct which will map to dispatch(const&, priority).
+	 */
+	auto getBoundDispatch(size_t priority) noexcept
+	{
+		assert(priority < TPriorityLevels && "Invalid dispatch priority");
+
+		return std::bind(
+			static_cast<void (PriorityDispatchQueue::*)(const DispatchFunc_t&, size_t)>(
+				&PriorityDispatchQueue::dispatch),
+			this, std::placeholders::_1, priority);
+	}
+
+	/** Get the current size of the operation queue.
+	 *
+	 * @returns the current number of enqueued operations, across all priority levels.
+	 */
+	size_t queue_size() const noexcept
+	{
+		return count_.load();
+	}
+
+	/** Get the current size of a single priority level.
+	 *
+	 * @param priority The priority level to check.
+	 * @returns the current number of enqueued operations at the requested priority level.
+	 */
+	size_t queue_size(size_t priority) const noexcept
+	{
+		assert(priority < TPriorityLevels && "Invalid dispatch priority");
+		return levels_[priority].size();
+	}
+
+	/** Get the capacity of the operation queue.
+	 *
+	 * @returns the capacity of a single priority level
+	 */
+	constexpr size_t capacity() const noexcept
+	{
+		return levels_[0].capacity();
+	}
+
+	/** Get the number of priority levels.
+	 *
+	 * @returns the number of priority levels supported by this queue.
+	 */
+	constexpr size_t priority_levels() const noexcept
+	{
+		return TPriorityLevels;
+	}
+
+	/** Get the number of threads used by this dispatch queue.
+	 *
+	 * @return the number of threads associated with this dispatch queue
+	 */
+	constexpr size_t thread_count() const noexcept
+	{
+		return threads_.size();
+	}
+
+  private:
+	/// Check that the requested level has space. Must be called with lock_ held.
+	/// Operations which are running still hold their level's StaticFunctionQueue memory, so they
+	/// count toward the capacity.
+	void check_capacity(size_t priority) noexcept
+	{
+		if constexpr(TSize > 0)
+		{
+			assert(levels_[priority].size() + running_[priority] < levels_[priority].capacity() &&
+				   "Max dispatch operations reached - increase PriorityDispatchQueue::TSize\n");
+		}
+
+		(void)priority;
+	}
+
+	/** Pick the level to service next. Must be called with lock_ held.
+	 *
+	 * @pre At least one level has an operation.
+	 * @returns the index of the level to pop from.
+	 */
+	size_t select_level() noexcept
+	{
+		size_t selected = 0;
+
+		while(levels_[selected].empty())
+		{
+			selected++;
+		}
+
+		if constexpr(TAgingLimit > 0)
+		{
+			for(size_t i = selected + 1; i < TPriorityLevels; i++)
+			{
+				if(levels_[i].empty())
+				{
+					continue;
+				}
+
+				if(skipped_[i] >= TAgingLimit)
+				{
+					selected = i;
+					break;
+				}
+
+				skipped_[i]++;
+			}
+
+			skipped_[selected] = 0;
+		}
+
+		return selected;
+	}
+
+	/** Worker thread handler.
+	 *
+	 * - Threads sleep until there is work in the queue (or quit_ is set)
+	 * - Whenever work is available, an operation is popped from the highest-priority
+	 *	non-empty level (subject to aging) and processed locally by the worker thread.
+	 * - When there is no longer any work available, the worker thread sleeps until notified
+	 */
+	void dispatch_thread_handler() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+
+		do
+		{
+			// Wait until we have data or a quit signal
+			cv_.wait(lock, [this] { return (quit_ || count_ > 0); });
+
+			// after wait, we own the lock
+			if(!quit_ && count_ > 0)
+			{
+				auto selected = select_level();
+				auto& level = levels_[selected];
+				auto op = std::move(level.front());
+				level.pop();
+				count_--;
+				running_[selected]++;
+
+				// unlock now that we're done messing with the queue
+				lock.unlock();
+
+				if constexpr(TSize > 0)
+				{
+					op->exec();
+				}
+				else
+				{
+					op();
+				}
+
+				lock.lock();
+
+				// Release the operation (and its queue memory) while holding the lock
+				op = nullptr;
+				running_[selected]--;
+			}
+		} while(!quit_);
+
+		lock.unlock();
+	}
+
+  private:
+	/// Name of the dispatch queue.
+	const std::string_view name_;
+	/// Instance of the lock used to protect the operation queues.
+	TLock lock_;
+	/// Vector of threads which handle dispatch operations.
+	TVecType threads_;
+	/// The operation queues, indexed by priority.
+	std::array<TQueueType, TPriorityLevels> levels_;
+	/// Number of times each level has been passed over while non-empty (used for aging).
+	std::array<size_t, TPriorityLevels> skipped_{};
+	/// Number of operations from each level which are currently being executed.
+	std::array<size_t, TPriorityLevels> running_{};
+	/// Total number of enqueued operations.
+	std::atomic<size_t> count_ = 0;
+	/// The condition variable which is used to notify dispatch threads.
+	TCond cv_;
+	/// Flag used to signal to threads that it is time to shutdown the queue.
+	std::atomic<bool> quit_ = false;
+};
+
+/** Priority dispatch queue which uses dynamic memory allocation.
+ *
+ * @tparam TPriorityLevels The number of priority levels.
+ * @tparam TAgingLimit The number of times a non-empty level can be passed over before it is
+ *	serviced. 0 disables aging.
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TPriorityLevels, const size_t TAgingLimit = 0,
+		 typename TFunc = std::function<void()>, typename TLock = std::mutex,
+		 typename TCond = std::condition_variable>
+using DynamicPriorityDispatchQueue =
+	PriorityDispatchQueue<0, 0, TPriorityLevels, TAgingLimit, TFunc, TLock, TCond>;
+
+/** Priority dispatch queue which uses only static memory allocation.
+ *
+ * @tparam TSize The maximum number of operations per priority level.
+ * @tparam TThreadCount The number of threads to use with the dispatch queue.
+ * @tparam TPriorityLevels The number of priority levels.
+ * @tparam TAgingLimit The number of times a non-empty level can be passed over before it is
+ *	serviced. 0 disables aging.
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the lock. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TSize, const size_t TThreadCount, const size_t TPriorityLevels,
+		 const size_t TAgingLimit = 0, typename TFunc = stdext::inplace_function<void()>,
+		 typename TLock = std::mutex, typename TCond = std::condition_variable>
+using StaticPriorityDispatchQueue =
+	PriorityDispatchQueue<TSize, TThreadCount, TPriorityLevels, TAgingLimit, TFunc, TLock, TCond>;
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // PRIORITY_DISPATCH_HPP_
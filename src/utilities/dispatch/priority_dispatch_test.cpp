@@ -0,0 +1,193 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "priority_dispatch.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma mark - Helpers -
+
+static std::atomic<size_t> flag = 0;
+static std::atomic<bool> gate = false;
+static std::atomic<bool> started = false;
+static std::mutex order_mutex;
+static std::vector<int> order;
+
+static void test_count(void)
+{
+	flag++;
+}
+
+static void wait_for_gate(void)
+{
+	while(!gate)
+	{
+		std::this_thread::yield();
+	}
+}
+
+static void start_and_wait_for_gate(void)
+{
+	started = true;
+	wait_for_gate();
+}
+
+static void record(int value)
+{
+	std::lock_guard<std::mutex> lock(order_mutex);
+	order.push_back(value);
+}
+
+template<typename TQueue>
+static void wait_for_empty(const TQueue& q)
+{
+	for(int tries = 0; tries < 100 && q.queue_size() > 0; tries++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// Allow the final operation to complete
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create priority dispatch queue", "[utility/dispatch/priority]")
+{
+	embutil::StaticPriorityDispatchQueue<10, 1, 3> q("TestQueue");
+
+	CHECK(0 == q.queue_size());
+	CHECK(10 == q.capacity());
+	CHECK(3 == q.priority_levels());
+	CHECK(1 == q.thread_count());
+}
+
+TEST_CASE("Priority dispatch tracks per-level size", "[utility/dispatch/priority]")
+{
+	embutil::DynamicPriorityDispatchQueue<3> q("TestQueue", 0);
+
+	q.dispatch(test_count, 0);
+	q.dispatch(test_count, 2);
+	q.dispatch(test_count);
+
+	CHECK(3 == q.queue_size());
+	CHECK(1 == q.queue_size(0));
+	CHECK(0 == q.queue_size(1));
+	CHECK(2 == q.queue_size(2));
+}
+
+TEST_CASE("Higher priority operations run first", "[utility/dispatch/priority]")
+{
+	order.clear();
+	gate = false;
+
+	{
+		embutil::StaticPriorityDispatchQueue<16, 1, 3> q("TestQueue");
+
+		// Hold the worker so we can build up a backlog
+		q.dispatch(wait_for_gate, 0);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		q.dispatch([] { record(2); }, 2);
+		q.dispatch([] { record(1); }, 1);
+		q.dispatch([] { record(2); }, 2);
+		q.dispatch([] { record(0); }, 0);
+
+		gate = true;
+		wait_for_empty(q);
+	}
+
+	CHECK(order == std::vector<int>{0, 1, 2, 2});
+}
+
+TEST_CASE("Aging prevents starvation of low priority work", "[utility/dispatch/priority]")
+{
+	order.clear();
+	gate = false;
+
+	{
+		embutil::DynamicPriorityDispatchQueue<2, 2> q("TestQueue", 1);
+
+		q.dispatch(wait_for_gate, 0);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		q.dispatch([] { record(1); }, 1);
+		for(int i = 0; i < 4; i++)
+		{
+			q.dispatch([] { record(0); }, 0);
+		}
+
+		gate = true;
+		wait_for_empty(q);
+	}
+
+	// The low priority op is passed over twice, then serviced
+	CHECK(order == std::vector<int>{0, 0, 1, 0, 0});
+}
+
+TEST_CASE("Fill static priority dispatch queue then empty", "[utility/dispatch/priority]")
+{
+	const size_t num_threads = 2;
+	flag = 0;
+	embutil::StaticPriorityDispatchQueue<32, num_threads, 4> q("TestQueue", num_threads);
+
+	for(size_t p = 0; p < q.priority_levels(); p++)
+	{
+		for(size_t i = 0; i < q.capacity(); i++)
+		{
+			q.dispatch(test_count, p);
+		}
+	}
+
+	wait_for_empty(q);
+
+	CHECK(flag == q.capacity() * q.priority_levels());
+}
+
+TEST_CASE("Running operations count toward the level capacity", "[utility/dispatch/priority]")
+{
+	flag = 0;
+	gate = false;
+	started = false;
+
+	{
+		embutil::StaticPriorityDispatchQueue<4, 1, 2> q("TestQueue");
+
+		q.dispatch(start_and_wait_for_gate, 0);
+		while(!started)
+		{
+			std::this_thread::yield();
+		}
+
+		// The running operation still holds one of the level's slots
+		for(size_t i = 0; i < q.capacity() - 1; i++)
+		{
+			q.dispatch(test_count, 0);
+		}
+
+		// Other levels have their own slots
+		for(size_t i = 0; i < q.capacity(); i++)
+		{
+			q.dispatch(test_count, 1);
+		}
+
+		CHECK((2 * q.capacity() - 1) == q.queue_size());
+
+		gate = true;
+		wait_for_empty(q);
+
+		// The level can be refilled once its operations are released
+		for(size_t i = 0; i < q.capacity(); i++)
+		{
+			q.dispatch(test_count, 0);
+		}
+
+		wait_for_empty(q);
+	}
+
+	CHECK(flag == 3 * 4 - 1);
+}
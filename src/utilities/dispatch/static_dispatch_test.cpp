@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
 
 #include "dispatch.hpp"
+#include <array>
 #include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
@@ -87,3 +88,137 @@ TEST_CASE("Fill static dispatch queue then empty", "[utility/dispatch/static]")
 
 	CHECK(flag == q.capacity());
 }
+
+TEST_CASE("Static dispatch_bulk runs all operations", "[utility/dispatch/static]")
+{
+	const size_t qsize = 10;
+	using Queue_t = embutil::StaticDispatchQueue<qsize>;
+	flag = 0;
+	Queue_t q("TestQueue");
+	std::array<Queue_t::DispatchFunc_t, qsize> ops;
+	ops.fill(test_count);
+
+	q.dispatch_bulk(ops);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(flag == qsize);
+	CHECK(0 == q.queue_size());
+}
+
+TEST_CASE("Static dispatch queue drains multiple operations per wakeup",
+		  "[utility/dispatch/static]")
+{
+	const size_t qsize = 10;
+	using Queue_t = embutil::StaticDispatchQueue<qsize, 1, stdext::inplace_function<void()>,
+												 std::mutex, std::condition_variable, 4>;
+	flag = 0;
+	Queue_t q("TestQueue");
+
+	for(size_t i = 0; i < qsize; i++)
+	{
+		q.dispatch(test_count);
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	CHECK(flag == qsize);
+	CHECK(0 == q.queue_size());
+}
+
+TEST_CASE("Cancelled operations do not run on static queue", "[utility/dispatch/static]")
+{
+	embutil::StaticDispatchQueue<4> q("TestQueue");
+	embutil::CancellationToken token;
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	flag = 0;
+
+	// Hold the worker thread so the following operations stay queued
+	q.dispatch([&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	// The running operation and the queued operations use all of the queue memory
+	q.dispatch(test_count, token);
+	q.dispatch(test_count, token);
+	q.dispatch(test_count, token);
+	CHECK(3 == q.queue_size());
+
+	token.cancel();
+
+	// The cancelled operations are discarded, and their memory is reused
+	q.dispatch(test_count);
+	q.dispatch(test_count);
+	q.dispatch(test_count, token);
+	CHECK(3 == q.queue_size());
+
+	release = true;
+
+	while(flag < 3)
+	{
+		std::this_thread::yield();
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	CHECK(3 == flag);
+}
+
+TEST_CASE("Cancelled operations behind a live operation release their static queue memory",
+		  "[utility/dispatch/static]")
+{
+	embutil::StaticDispatchQueue<4> q("TestQueue");
+	embutil::CancellationToken token;
+	std::atomic<bool> started = false;
+	std::atomic<bool> release = false;
+	std::array<int, 4> order{};
+	std::atomic<size_t> ran = 0;
+	auto record = [&](int v) { order[ran++] = v; };
+
+	// Hold the worker thread so the following operations stay queued
+	q.dispatch([&] {
+		started = true;
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	while(!started)
+	{
+		std::this_thread::yield();
+	}
+
+	// The running operation and the queued operations use all of the queue memory. The live
+	// operation at the front keeps the revoked operation from being discarded there.
+	q.dispatch([&] { record(1); });
+	q.dispatch([&] { record(-1); }, token);
+	q.dispatch_barrier([&] { record(2); });
+	CHECK(3 == q.queue_size());
+
+	token.cancel();
+
+	// The queue is full, so the revoked operation is purged to make room
+	q.dispatch([&] { record(3); });
+	CHECK(3 == q.queue_size());
+
+	release = true;
+
+	while(ran < 3)
+	{
+		std::this_thread::yield();
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	CHECK(3 == ran);
+	CHECK(std::array<int, 4>{1, 2, 3, 0} == order);
+}
@@ -0,0 +1,489 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef WORK_STEALING_DISPATCH_HPP_
+#define WORK_STEALING_DISPATCH_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <etl/deque.h>
+#include <etl/vector.h>
+#include <functional>
+#include <inplace_function/inplace_function.hpp>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace embutil
+{
+/// @addtogroup DispatchQueue
+/// @{
+
+/** Dispatch queue which balances work across threads by work stealing.
+ *
+ * Unlike DispatchQueue_Base, where every worker pops from a single shared queue, each worker
+ * thread in a WorkStealingDispatchQueue owns a local deque:
+ *	- An operation dispatched from one of this queue's worker threads is pushed to that
+ *	  worker's own deque, so fan-out work stays on the thread (and cache) which produced it.
+ *	- An operation dispatched from any other thread is pushed to a shared injection queue,
+ *	  which workers drain in FIFO order.
+ *	- A worker pops its newest local operation first. When its deque is empty, it takes the
+ *	  oldest operation from the injection queue, and then steals the oldest operation from
+ *	  another worker's deque before parking.
+ *	- Every `inject_interval` operations, a worker checks the injection queue before its own
+ *	  deque, so a worker which keeps dispatching to itself cannot starve other threads.
+ *
+ * Each deque is protected by its own lock, so workers mostly touch their own lock instead of
+ * contending on a single queue lock. The shared lock is only used to park and wake workers.
+ *
+ * Operations dispatched from outside the queue start in dispatch order, but operations
+ * dispatched from the workers do not. Use a DispatchQueue_Base with a single thread if FIFO
+ * ordering is required for all operations.
+ *
+ * The queue provides the same dispatch interface as DispatchQueue_Base, so it can be used with
+ * `embvm::PlatformDispatcher`:
+ *
+ * @code
+ * using PlatformDispatchQueue = embutil::StaticWorkStealingDispatchQueue<64, 4>;
+ * @endcode
+ *
+ * Dispatch queues cannot be copied or moved.
+ *
+ * @tparam TSize The size of each worker's deque and of the injection queue. When TSize is 0,
+ *	dynamic memory allocation will be used. Otherwise static memory types are used, and each
+ *	deque can hold up to TSize operations.
+ * @tparam TThreadCount The maximum number of threads to use with the dispatch queue. When
+ *	TThreadCount is 0, the worker storage is dynamically allocated.
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the locks. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TSize, const size_t TThreadCount,
+		 typename TFunc = stdext::inplace_function<void()>, typename TLock = std::mutex,
+		 typename TCond = std::condition_variable>
+class WorkStealingDispatchQueue
+{
+	/// Type definition for a worker's local deque.
+	/// If TSize is 0, std::deque will be used (dynamic memory mode). Otherwise an etl::deque
+	/// of size TSize is used.
+	using TDequeType = typename std::conditional<(TSize == 0), std::deque<TFunc>,
+												 etl::deque<TFunc, TSize>>::type;
+
+	/// Per-worker state.
+	struct Worker
+	{
+		/// The worker thread.
+		std::thread thread{};
+		/// Lock which protects the local deque.
+		TLock lock{};
+		/// Operations which are waiting to run on (or be stolen from) this worker.
+		TDequeType q{};
+	};
+
+	/// Type definition for the worker storage.
+	/// std::deque is used in dynamic mode because it never relocates its elements.
+	using TWorkerStorage = typename std::conditional<(TThreadCount == 0), std::deque<Worker>,
+													 etl::vector<Worker, TThreadCount>>::type;
+
+  public:
+	/// Public alias for the dispatch functor type.
+	using DispatchFunc_t = TFunc;
+
+	/// Number of operations a worker runs between forced checks of the injection queue.
+	static constexpr size_t inject_interval = 32;
+
+	/** Create an unnamed dispatch queue.
+	 *
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit WorkStealingDispatchQueue(size_t thread_count = 1) noexcept
+		: WorkStealingDispatchQueue(std::string_view("GenericDispatchQueue"), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a C-string name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit WorkStealingDispatchQueue(const char* name, size_t thread_count = 1) noexcept
+		: WorkStealingDispatchQueue(std::string_view(name), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a std::string name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * 	@note A std::string_view is stored, so the original std::string must remain valid.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit WorkStealingDispatchQueue(const std::string& name, size_t thread_count = 1) noexcept
+		: WorkStealingDispatchQueue(std::string_view(name), thread_count)
+	{
+	}
+
+	/** Create a dispatch queue with a std::string_view name.
+	 *
+	 * @param name The name of the dispatch queue.
+	 * @param thread_count Optional parameter that determines the number of threads associated with
+	 * 	this queue. thread_count cannot exceed TThreadCount.
+	 */
+	explicit WorkStealingDispatchQueue(const std::string_view name,
+									   size_t thread_count = 1) noexcept
+		: name_(name)
+	{
+		if constexpr(TThreadCount > 0)
+		{
+			assert(thread_count <= TThreadCount && "thread_count cannot exceed TThreadCount");
+		}
+
+		// Workers must all exist before any thread starts, since threads steal from each other
+		for(size_t i = 0; i < thread_count; i++)
+		{
+			workers_.emplace_back();
+		}
+
+		for(size_t i = 0; i < thread_count; i++)
+		{
+			workers_[i].thread =
+				std::thread(&WorkStealingDispatchQueue::dispatch_thread_handler, this, i);
+		}
+	}
+
+	/** Default destructor.
+	 *
+	 * The destructor notifies dispatch threads that it is time to quit and waits for them to exit.
+	 * Operations which have not started yet are discarded.
+	 */
+	~WorkStealingDispatchQueue() noexcept
+	{
+		std::unique_lock<TLock> lock(lock_);
+		quit_ = true;
+		lock.unlock();
+		cv_.notify_all();
+
+		for(auto& w : workers_)
+		{
+			if(w.thread.joinable())
+			{
+				w.thread.join();
+			}
+		}
+	}
+
+	/// Deleted copy constructor
+	WorkStealingDispatchQueue(const WorkStealingDispatchQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	const WorkStealingDispatchQueue& operator=(const WorkStealingDispatchQueue&) = delete;
+
+	/// Deleted move constructor
+	WorkStealingDispatchQueue(WorkStealingDispatchQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	WorkStealingDispatchQueue& operator=(WorkStealingDispatchQueue&&) = delete;
+
+	/** Dispatch an operation
+	 *
+	 * When called from one of this queue's worker threads, the operation is pushed to that
+	 * worker's local deque, or to the injection queue if the local deque is full. Otherwise, the
+	 * operation is pushed to the injection queue. A parked worker is woken if one is available.
+	 *
+	 * @pre The queue has at least one worker thread.
+	 * @param op The operation to dispatch to a worker thread.
+	 */
+	void dispatch(const TFunc& op) noexcept
+	{
+		enqueue(op);
+	}
+
+	/// @overload void dispatch(const TFunc& op)
+	void dispatch(TFunc&& op) noexcept
+	{
+		enqueue(std::move(op));
+	}
+
+	/** Get a std::bind object for the instance's dispatch(const&) function.
+	 *
+	 * @returns std::bind construct which will map to the the dispatch(const&) function
+	 *	for this queue instance.
+	 */
+	auto getBoundDispatch() noexcept
+	{
+		return std::bind(static_cast<void (WorkStealingDispatchQueue::*)(const DispatchFunc_t&)>(
+							 &WorkStealingDispatchQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/** Get a std::bind object for the instance's dispatch(&&) function.
+	 *
+	 * @returns std::bind construct which will map to the the dispatch(&&) function
+	 *	for this queue instance.
+	 */
+	auto getBoundMoveDispatch() noexcept
+	{
+		return std::bind(static_cast<void (WorkStealingDispatchQueue::*)(DispatchFunc_t &&)>(
+							 &WorkStealingDispatchQueue::dispatch),
+						 this, std::placeholders::_1);
+	}
+
+	/** Get the current number of enqueued operations, across all workers.
+	 *
+	 * @returns the current number of enqueued operations.
+	 */
+	size_t queue_size() const noexcept
+	{
+		return pending_.load();
+	}
+
+	/** Get the total capacity of the worker deques and the injection queue.
+	 *
+	 * Operations dispatched from outside the queue can only use the injection queue, which holds
+	 * up to TSize operations.
+	 *
+	 * @returns the number of operations that can be enqueued across all deques, or 0 if dynamic
+	 *	memory is used.
+	 */
+	size_t capacity() const noexcept
+	{
+		return TSize * (workers_.size() + 1);
+	}
+
+	/** Get the number of threads used by this dispatch queue.
+	 *
+	 * @return the number of threads associated with this dispatch queue
+	 */
+	size_t thread_count() const noexcept
+	{
+		return workers_.size();
+	}
+
+  private:
+	/// Return the index of the worker running on the calling thread, or workers_.size() if the
+	/// caller is not one of this queue's workers.
+	size_t current_worker() const noexcept
+	{
+		return (current_queue_ == this) ? current_index_ : workers_.size();
+	}
+
+	/// Try to push to a deque. Returns false if the deque is full.
+	template<typename TOp>
+	bool push_to(TLock& deque_lock, TDequeType& q, TOp&& op) noexcept
+	{
+		std::lock_guard<TLock> lock(deque_lock);
+
+		if constexpr(TSize > 0)
+		{
+			if(q.full())
+			{
+				return false;
+			}
+		}
+
+		q.push_back(std::forward<TOp>(op));
+		return true;
+	}
+
+	/** Push an operation to a worker and wake a parked worker if needed.
+	 *
+	 * pending_ is incremented before the push, and sleepers_ is checked after it. Workers
+	 * increment sleepers_ before checking pending_, so either the producer sees the parked
+	 * worker, or the worker sees the new operation.
+	 */
+	template<typename TOp>
+	void enqueue(TOp&& op) noexcept
+	{
+		assert(workers_.size() > 0 && "WorkStealingDispatchQueue requires at least one thread");
+
+		size_t index = current_worker();
+
+		pending_++;
+
+		// If the worker's own deque is full, spill over to the injection queue
+		bool pushed = false;
+		if(index < workers_.size())
+		{
+			auto& w = workers_[index];
+			pushed = push_to(w.lock, w.q, std::forward<TOp>(op));
+		}
+
+		if(!pushed)
+		{
+			pushed = push_to(inject_lock_, inject_q_, std::forward<TOp>(op));
+		}
+
+		if(!pushed)
+		{
+			pending_--;
+			// The target deques are full - increase WorkStealingDispatchQueue::TSize
+			assert(0 && "Max dispatch operations reached");
+			return;
+		}
+
+		if(sleepers_.load() > 0)
+		{
+			// Taking the lock ensures a worker which is about to park is already waiting
+			std::unique_lock<TLock> lock(lock_);
+			lock.unlock();
+			cv_.notify_one();
+		}
+	}
+
+	/// Pop the newest operation from the worker's own deque.
+	bool pop_local(Worker& w, TFunc& op) noexcept
+	{
+		std::lock_guard<TLock> lock(w.lock);
+
+		if(w.q.empty())
+		{
+			return false;
+		}
+
+		op = std::move(w.q.back());
+		w.q.pop_back();
+		return true;
+	}
+
+	/// Pop the oldest operation from the injection queue.
+	bool pop_injected(TFunc& op) noexcept
+	{
+		std::lock_guard<TLock> lock(inject_lock_);
+
+		if(inject_q_.empty())
+		{
+			return false;
+		}
+
+		op = std::move(inject_q_.front());
+		inject_q_.pop_front();
+		return true;
+	}
+
+	/// Steal the oldest operation from another worker's deque.
+	bool steal(size_t index, TFunc& op) noexcept
+	{
+		for(size_t i = 1; i < workers_.size(); i++)
+		{
+			auto& victim = workers_[(index + i) % workers_.size()];
+			std::lock_guard<TLock> lock(victim.lock);
+
+			if(!victim.q.empty())
+			{
+				op = std::move(victim.q.front());
+				victim.q.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/** Worker thread handler.
+	 *
+	 * - Threads run operations from their own deque, newest first
+	 * - When their deque is empty, threads run the oldest operation from the injection queue
+	 * - Every inject_interval operations, the injection queue is checked first
+	 * - When both are empty, threads steal the oldest operation from another worker
+	 * - When no work can be found, the worker parks on the condition variable until work is
+	 *	available (or quit_ is set)
+	 *
+	 * @param index The index of this thread's Worker entry.
+	 */
+	void dispatch_thread_handler(size_t index) noexcept
+	{
+		auto& self = workers_[index];
+		TFunc op;
+		size_t ticks = 0;
+
+		current_queue_ = this;
+		current_index_ = index;
+
+		while(!quit_)
+		{
+			bool inject_first = (++ticks % inject_interval) == 0;
+
+			if((inject_first && pop_injected(op)) || pop_local(self, op) || pop_injected(op) ||
+			   steal(index, op))
+			{
+				pending_--;
+				op();
+				op = nullptr;
+				continue;
+			}
+
+			std::unique_lock<TLock> lock(lock_);
+			sleepers_++;
+			cv_.wait(lock, [this] { return (quit_ || pending_.load() > 0); });
+			sleepers_--;
+		}
+	}
+
+  private:
+	/// Name of the dispatch queue.
+	const std::string_view name_;
+	/// Lock used only for parking and waking worker threads.
+	TLock lock_;
+	/// The condition variable which is used to wake parked dispatch threads.
+	TCond cv_;
+	/// Worker threads and their local deques.
+	TWorkerStorage workers_;
+	/// Lock which protects the injection queue.
+	TLock inject_lock_;
+	/// Operations dispatched from outside the queue, which are run in FIFO order.
+	TDequeType inject_q_{};
+	/// Number of operations which have been dispatched but not yet started.
+	std::atomic<size_t> pending_ = 0;
+	/// Number of worker threads which are parked (or about to park).
+	std::atomic<size_t> sleepers_ = 0;
+	/// Flag used to signal to threads that it is time to shutdown the queue.
+	std::atomic<bool> quit_ = false;
+	/// The queue which owns the worker running on the calling thread, if any.
+	static inline thread_local const WorkStealingDispatchQueue* current_queue_ = nullptr;
+	/// The index of the worker running on the calling thread. Valid if current_queue_ is set.
+	static inline thread_local size_t current_index_ = 0;
+};
+
+/** Work-stealing dispatch queue which uses dynamic memory allocation.
+ *
+ * @note To instantiate with default TFunc type, use `DynamicWorkStealingDispatchQueue<>`.
+ *
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the locks. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<typename TFunc = std::function<void()>, typename TLock = std::mutex,
+		 typename TCond = std::condition_variable>
+using DynamicWorkStealingDispatchQueue = WorkStealingDispatchQueue<0, 0, TFunc, TLock, TCond>;
+
+/** Work-stealing dispatch queue which uses only static memory allocation.
+ *
+ * @tparam TSize The size of each worker's deque and of the injection queue.
+ * @tparam TThreadCount The maximum number of threads to use with the dispatch queue.
+ * @tparam TFunc The type representing a dispatch function prototype. Defaults to any functor
+ *	which can be represented by `void(void)`.
+ * @tparam TLock Type to use for the locks. Can be overriden if a custom mutex/lock should be used.
+ * @tparam TCond Type to use for the condition variable. Can be overridden if a custom condition
+ *	variable implementation should be used.
+ */
+template<const size_t TSize, const size_t TThreadCount = 1,
+		 typename TFunc = stdext::inplace_function<void()>, typename TLock = std::mutex,
+		 typename TCond = std::condition_variable>
+using StaticWorkStealingDispatchQueue =
+	WorkStealingDispatchQueue<TSize, TThreadCount, TFunc, TLock, TCond>;
+
+/// @}
+// End DispatchQueue
+
+} // namespace embutil
+
+#endif // WORK_STEALING_DISPATCH_HPP_
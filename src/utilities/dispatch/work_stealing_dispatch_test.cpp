@@ -0,0 +1,200 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "work_stealing_dispatch.hpp"
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma mark - Helpers -
+
+static std::atomic<size_t> flag = 0;
+
+static void test_flag(void)
+{
+	flag = 1;
+}
+
+static void test_count(void)
+{
+	flag++;
+}
+
+template<typename TQueue>
+static void wait_for_count(const TQueue& q, size_t count)
+{
+	for(int tries = 0; tries < 500 && (flag < count || q.queue_size() > 0); tries++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create work-stealing dispatch queue", "[utility/dispatch/work_stealing]")
+{
+	const size_t num_threads = 4;
+	embutil::StaticWorkStealingDispatchQueue<16, num_threads> q("TestQueue", num_threads);
+
+	SECTION("Queue starts empty")
+	{
+		CHECK(0 == q.queue_size());
+	}
+
+	SECTION("Capacity covers the worker deques and the injection queue")
+	{
+		CHECK(16 * (num_threads + 1) == q.capacity());
+	}
+
+	SECTION("Queue threads matches definition")
+	{
+		CHECK(num_threads == q.thread_count());
+	}
+}
+
+TEST_CASE("Dispatch function runs on work-stealing queue", "[utility/dispatch/work_stealing]")
+{
+	flag = 0;
+	embutil::DynamicWorkStealingDispatchQueue<> q("TestQueue", 2);
+
+	q.dispatch(test_flag);
+	wait_for_count(q, 1);
+
+	CHECK(flag == 1);
+}
+
+TEST_CASE("Fill static work-stealing queue then empty", "[utility/dispatch/work_stealing]")
+{
+	const size_t num_threads = 4;
+	const size_t queue_size = 32;
+	flag = 0;
+	embutil::StaticWorkStealingDispatchQueue<queue_size, num_threads> q("TestQueue", num_threads);
+
+	// Operations dispatched from this thread can only fill the injection queue
+	for(size_t i = 0; i < queue_size; i++)
+	{
+		q.dispatch(test_count);
+	}
+
+	wait_for_count(q, queue_size);
+
+	CHECK(flag == queue_size);
+}
+
+TEST_CASE("Operations dispatched from other threads start in FIFO order",
+		  "[utility/dispatch/work_stealing]")
+{
+	std::mutex order_lock;
+	std::vector<int> order;
+	std::atomic<bool> release = false;
+	flag = 0;
+	embutil::StaticWorkStealingDispatchQueue<8, 1> q("TestQueue", 1);
+	embutil::StaticWorkStealingDispatchQueue<8, 1> producer("Producer", 1);
+
+	// Hold the worker so the following operations are all queued before any of them runs
+	q.dispatch([&release] {
+		while(!release)
+		{
+			std::this_thread::yield();
+		}
+	});
+
+	auto record = [&order, &order_lock](int value) {
+		return [&order, &order_lock, value] {
+			std::lock_guard<std::mutex> lock(order_lock);
+			order.push_back(value);
+			flag++;
+		};
+	};
+
+	for(int i = 1; i <= 3; i++)
+	{
+		q.dispatch(record(i));
+	}
+
+	// A worker of another queue is also an external thread for this queue
+	producer.dispatch([&] {
+		for(int i = 4; i <= 6; i++)
+		{
+			q.dispatch(record(i));
+		}
+	});
+	for(int tries = 0; tries < 500 && q.queue_size() < 6; tries++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	release = true;
+	wait_for_count(q, 6);
+
+	CHECK(std::vector<int>{1, 2, 3, 4, 5, 6} == order);
+}
+
+TEST_CASE("Operations dispatched from a worker are run", "[utility/dispatch/work_stealing]")
+{
+	const size_t fan_out = 100;
+	flag = 0;
+	embutil::DynamicWorkStealingDispatchQueue<> q("TestQueue", 4);
+
+	// The fan-out ops land on the dispatching worker's deque, and idle workers steal them
+	q.dispatch([&q] {
+		for(size_t i = 0; i < fan_out; i++)
+		{
+			q.dispatch(test_count);
+		}
+	});
+
+	wait_for_count(q, fan_out);
+
+	CHECK(flag == fan_out);
+}
+
+TEST_CASE("Work-stealing queue works with PlatformDispatcher-style binding",
+		  "[utility/dispatch/work_stealing]")
+{
+	flag = 0;
+	embutil::StaticWorkStealingDispatchQueue<8, 2> q("TestQueue", 2);
+	auto d = q.getBoundDispatch();
+
+	d(test_flag);
+	wait_for_count(q, 1);
+
+	CHECK(flag == 1);
+}
+
+TEST_CASE("Work-stealing queue scaling", "[utility/dispatch/work_stealing][!benchmark]")
+{
+	constexpr size_t num_ops = 10000;
+
+	auto run = [](auto& q) {
+		flag = 0;
+		for(size_t i = 0; i < num_ops; i++)
+		{
+			q.dispatch(test_count);
+		}
+
+		while(flag < num_ops)
+		{
+			std::this_thread::yield();
+		}
+
+		return flag.load();
+	};
+
+	embutil::DynamicWorkStealingDispatchQueue<> q1("1 thread", 1);
+	embutil::DynamicWorkStealingDispatchQueue<> q4("4 threads", 4);
+
+	BENCHMARK("1 worker thread")
+	{
+		return run(q1);
+	};
+
+	BENCHMARK("4 worker threads")
+	{
+		return run(q4);
+	};
+}
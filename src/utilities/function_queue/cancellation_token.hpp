@@ -0,0 +1,99 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef CANCELLATION_TOKEN_HPP_
+#define CANCELLATION_TOKEN_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+namespace embutil
+{
+/// @addtogroup FunctionQueue
+/// @{
+
+/** Token used to revoke queued operations.
+ *
+ * Operations are queued with a token, and cancel() revokes every operation which was queued with
+ * that token before the call. Revoked operations are discarded when they reach the front of the
+ * queue, without being executed. Operations queued after cancel() are not affected, so a token
+ * can be reused when a driver restarts.
+ *
+ * @code
+ * embutil::CancellationToken token;
+ *
+ * q.dispatch(read_sensor, token);
+ * q.dispatch(process_sample, token);
+ *
+ * // Driver stops: neither operation runs if it has not started yet
+ * token.cancel();
+ * @endcode
+ *
+ * An operation which has already been removed from the queue by a worker thread is not affected
+ * by cancel(), and may still be running when cancel() returns.
+ *
+ * @note The token must outlive all operations which were queued with it.
+ */
+class CancellationToken
+{
+  public:
+	/// Identifies the token generation when an operation was queued.
+	using ticket_t = uint32_t;
+
+	/// Default constructor
+	CancellationToken() noexcept = default;
+
+	/// Default destructor
+	~CancellationToken() noexcept = default;
+
+	/// Deleted copy constructor
+	CancellationToken(const CancellationToken&) = delete;
+
+	/// Deleted copy assignment operator
+	auto operator=(const CancellationToken&) -> const CancellationToken& = delete;
+
+	/// Deleted move constructor
+	CancellationToken(CancellationToken&&) = delete;
+
+	/// Deleted move assignment operator
+	auto operator=(CancellationToken&&) -> CancellationToken& = delete;
+
+	/** Revoke all operations which have been queued with this token.
+	 *
+	 * This function is safe to call from any thread.
+	 */
+	void cancel() noexcept
+	{
+		generation_.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	/** Get a ticket for an operation which is being queued.
+	 *
+	 * @returns the ticket to store with the operation.
+	 */
+	[[nodiscard]] auto ticket() const noexcept -> ticket_t
+	{
+		return generation_.load(std::memory_order_acquire);
+	}
+
+	/** Check whether an operation has been revoked.
+	 *
+	 * @param t The ticket stored with the operation.
+	 * @returns true if cancel() was called after the ticket was issued.
+	 */
+	[[nodiscard]] auto cancelled(ticket_t t) const noexcept -> bool
+	{
+		return generation_.load(std::memory_order_acquire) != t;
+	}
+
+  private:
+	/// Incremented each time the token is cancelled.
+	std::atomic<ticket_t> generation_{0};
+};
+
+/// @}
+// End FunctionQueue
+
+} // namespace embutil
+
+#endif // CANCELLATION_TOKEN_HPP_
@@ -4,6 +4,7 @@
 #ifndef FUNCTION_QUEUE_HPP_
 #define FUNCTION_QUEUE_HPP_
 
+#include "cancellation_token.hpp"
 #include <etl/function.h>
 #include <etl/largest.h>
 #include <etl/pool.h>
@@ -59,6 +60,18 @@ class FuncOp
 	 */
 	virtual void exec() {}
 
+	/** Check whether the function has been revoked.
+	 *
+	 * Base class functions cannot be revoked. Derived FuncOpCancellable classes overload this
+	 * to check their CancellationToken.
+	 *
+	 * @returns true if the function should be discarded without being executed.
+	 */
+	[[nodiscard]] virtual auto cancelled() const -> bool
+	{
+		return false;
+	}
+
 	/// operator() invokes the function.
 	void operator()()
 	{
@@ -111,6 +124,68 @@ class FuncOpBound final : public FuncOp
 	TFuncOp op_;
 };
 
+/** Represents a bound function object which can be revoked
+ *
+ * The function is stored along with a CancellationToken and the ticket that was issued when the
+ * function was queued.
+ *
+ * @tparam TFuncOp The function prototype to store in the bound object.
+ * @related StaticFunctionQueue
+ */
+template<typename TFuncOp>
+class FuncOpCancellable final : public FuncOp
+{
+  public:
+	/** Construct the FuncOpCancellable object with an operation.
+	 *
+	 * @param input_op The operation to bind. Can be any functor.
+	 * @param token The token which can revoke the operation.
+	 */
+	FuncOpCancellable(const TFuncOp& input_op, const CancellationToken& token)
+		: op_(input_op), token_(&token), ticket_(token.ticket())
+	{
+	}
+
+	/** Construct the FuncOpCancellable object with an operation.
+	 *
+	 * @param input_op The operation to bind. Can be any functor.
+	 * @param token The token which can revoke the operation.
+	 */
+	FuncOpCancellable(TFuncOp&& input_op, const CancellationToken& token)
+		: op_(std::move(input_op)), token_(&token), ticket_(token.ticket())
+	{
+	}
+
+	/// Default destructor
+	~FuncOpCancellable() final = default;
+
+	// Default the rest
+	FuncOpCancellable(const FuncOpCancellable&) = default;
+	FuncOpCancellable(FuncOpCancellable&&) = default;
+	auto operator=(const FuncOpCancellable&) noexcept -> FuncOpCancellable& = default;
+	auto operator=(FuncOpCancellable&&) noexcept -> FuncOpCancellable& = default;
+
+	/// Invoke the bound operation.
+	void exec() final
+	{
+		op_();
+	}
+
+	/// Check the token to see if the operation has been revoked.
+	[[nodiscard]] auto cancelled() const -> bool final
+	{
+		return token_->cancelled(ticket_);
+	}
+
+  private:
+	/// The bound functor.
+	TFuncOp op_;
+	/// The token which can revoke the operation.
+	const CancellationToken* token_;
+	/// The token ticket issued when the operation was queued.
+	CancellationToken::ticket_t ticket_;
+};
+
 #pragma mark - Function Queue Base -
 
 /** Static-memory function queue that accepts functors of multiple sizes.
@@ -157,6 +232,13 @@ class FuncOpBound final : public FuncOp
  * If a single thread is managing the queue, popAndExec() can be used to remove the function from
  * the queue and execute it.
  *
+ * Functions can also be pushed with a CancellationToken. Once the token is cancelled, the
+ * function is skipped: discard_cancelled() removes revoked functions from the front of the queue
+ * and returns their memory to the pool without executing them, and popAndExec() does not execute
+ * them. Call discard_cancelled() before front() to avoid taking a revoked function.
+ * purge_cancelled() also removes revoked functions which are queued behind a function that has
+ * not been revoked, which reclaims their memory when the queue is full.
+ *
  * @tparam TFunc The functor storage type, such as std::function or stdext::inplace_function.
  * @tparam TQueueElements The number of elements to store in the queue. TQueueElements must be > 0.
  * @tparam TLargestSize The size of the largest expected allocation, in bytes.
@@ -258,12 +340,104 @@ class StaticFunctionQueue
 		queue_.emplace(mem_pool_.template create<FuncBoundType>(std::forward<TFuncOp>(input_op)));
 	}
 
+	/** Add a function which can be revoked to the queue.
+	 *
+	 * @tparam TFuncOp The type of the functor to add to the queue. This template parameter is
+	 * 	automatically deduced by the compiler.
+	 * @param input_op The functor object to add to the queue.
+	 * @param token The token which can revoke the functor. The token must outlive the functor's
+	 *	storage in the queue.
+	 */
+	template<typename TFuncOp>
+	void push(TFuncOp&& input_op, const CancellationToken& token) noexcept
+	{
+		using FuncBoundType = FuncOpCancellable<typename std::decay<TFuncOp>::type>;
+
+		static_assert(std::alignment_of<FuncBoundType>::value % std::alignment_of<FuncOp>::value ==
+						  0,
+					  "Alignment of FuncBoundType must be a multiple of the alignment of FuncOp");
+
+		assert((queue_.size() < queue_.capacity()) &&
+			   "Could not allocate space for function object");
+		queue_.emplace(
+			mem_pool_.template create<FuncBoundType>(std::forward<TFuncOp>(input_op), token));
+	}
+
+	/** Remove revoked functions from the front of the queue.
+	 *
+	 * Functions are removed until the queue is empty or the front function has not been revoked.
+	 * Their memory is returned to the pool immediately, and they are not executed.
+	 *
+	 * @returns the number of functions which were removed.
+	 */
+	auto discard_cancelled() noexcept -> size_t
+	{
+		size_t count = 0;
+
+		for(; !queue_.empty() && queue_.front()->cancelled(); count++)
+		{
+			deleter(queue_.front());
+			queue_.pop();
+		}
+
+		return count;
+	}
+
+	/** Remove revoked functions from anywhere in the queue.
+	 *
+	 * Unlike discard_cancelled(), every function in the queue is checked, so this is an O(n)
+	 * operation. The remaining functions keep their order. The memory for the removed functions
+	 * is returned to the pool immediately, and they are not executed.
+	 *
+	 * @tparam TVisitor The type of the visitor. Deduced by the compiler.
+	 * @param visit Called once for each function, in queue order, with true if the function was
+	 *	removed. This lets callers keep side tables in sync with the queue.
+	 * @returns the number of functions which were removed.
+	 */
+	template<typename TVisitor>
+	auto purge_cancelled(TVisitor&& visit) noexcept -> size_t
+	{
+		size_t count = 0;
+
+		for(size_t i = queue_.size(); i > 0; i--)
+		{
+			auto ptr = queue_.front();
+			queue_.pop();
+
+			bool discard = ptr->cancelled();
+			if(discard)
+			{
+				deleter(ptr);
+				count++;
+			}
+			else
+			{
+				queue_.push(ptr);
+			}
+
+			visit(discard);
+		}
+
+		return count;
+	}
+
+	/// @overload auto purge_cancelled(TVisitor&& visit) noexcept -> size_t
+	auto purge_cancelled() noexcept -> size_t
+	{
+		return purge_cancelled([](bool) noexcept {});
+	}
+
 	/// Remove the next functor from the front of the queue and execute it.
+	/// A revoked functor is removed without being executed.
 	void popAndExec() noexcept
 	{
 		auto ptr = queue_.front();
 		queue_.pop();
-		ptr->exec();
+
+		if(!ptr->cancelled())
+		{
+			ptr->exec();
+		}
 
 		// we call the deleter manually b/c we haven't created a std::unique_ptr
 		// in this scenario
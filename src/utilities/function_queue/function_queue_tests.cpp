@@ -3,6 +3,7 @@
 
 #include "function_queue.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <vector>
 
 using namespace embutil;
 
@@ -102,3 +103,89 @@ TEST_CASE("Test use with std::function", "[utility/function_queue]")
 	CHECK(2 == test_counter);
 	CHECK(2 == test_counter2);
 }
+
+TEST_CASE("Cancelled functions are discarded without executing", "[utility/function_queue]")
+{
+	embutil::StaticFunctionQueue<4> fq;
+	CancellationToken token;
+	test_counter = 0;
+	test_counter2 = 0;
+
+	fq.push(test_func, token);
+	fq.push(test_func, token);
+	fq.push(test_func2);
+
+	token.cancel();
+
+	// Functions queued after cancel() are not revoked
+	fq.push(test_func, token);
+
+	CHECK(2 == fq.discard_cancelled());
+	CHECK(2 == fq.size());
+
+	// The memory for the discarded functions can be reused
+	fq.push(test_func2);
+	fq.push(test_func2);
+	CHECK(4 == fq.size());
+
+	while(!fq.empty())
+	{
+		fq.popAndExec();
+	}
+
+	CHECK(1 == test_counter);
+	CHECK(3 == test_counter2);
+}
+
+TEST_CASE("Cancelled functions behind a live function are purged", "[utility/function_queue]")
+{
+	embutil::StaticFunctionQueue<4> fq;
+	CancellationToken token;
+	test_counter = 0;
+	test_counter2 = 0;
+
+	fq.push(test_func2);
+	fq.push(test_func, token);
+	fq.push(test_func2);
+	fq.push(test_func, token);
+
+	token.cancel();
+
+	// The front function is live, so nothing is discarded from the front
+	CHECK(0 == fq.discard_cancelled());
+	CHECK(4 == fq.size());
+
+	std::vector<bool> visited;
+	CHECK(2 == fq.purge_cancelled([&](bool discarded) { visited.push_back(discarded); }));
+	CHECK(std::vector<bool>{false, true, false, true} == visited);
+	CHECK(2 == fq.size());
+
+	// The memory for the purged functions can be reused
+	fq.push(test_func2);
+	fq.push(test_func2);
+
+	while(!fq.empty())
+	{
+		fq.popAndExec();
+	}
+
+	CHECK(0 == test_counter);
+	CHECK(4 == test_counter2);
+}
+
+TEST_CASE("popAndExec skips cancelled functions", "[utility/function_queue]")
+{
+	embutil::StaticFunctionQueue<4> fq;
+	CancellationToken token;
+	test_counter = 0;
+
+	fq.push(test_func, token);
+	fq.push(test_func, token);
+	token.cancel();
+
+	fq.popAndExec();
+	fq.popAndExec();
+
+	CHECK(0 == fq.size());
+	CHECK(0 == test_counter);
+}
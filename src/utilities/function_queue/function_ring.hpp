@@ -0,0 +1,422 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef FUNCTION_RING_HPP_
+#define FUNCTION_RING_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace embutil
+{
+/// @addtogroup FunctionQueue
+/// @{
+
+/** Header for a functor stored in a StaticFunctionRing.
+ *
+ * Each record is a header followed by the functor object. Instead of a vtable, the header holds a
+ * type-erased thunk which locates the functor behind the header and either invokes or destroys it.
+ *
+ * @related StaticFunctionRing
+ */
+class FuncRecord
+{
+  public:
+	/// Operations supported by the record thunk.
+	enum class ThunkOp : uint8_t
+	{
+		invoke = 0,
+		destroy,
+	};
+
+	/// Type-erased function which invokes or destroys a stored functor.
+	using Thunk_t = void (*)(FuncRecord* record, ThunkOp op);
+
+	/** Construct a record header.
+	 *
+	 * @param thunk The thunk for the stored functor type.
+	 * @param size The size of the record, including the header, in bytes.
+	 */
+	FuncRecord(Thunk_t thunk, uint32_t size) noexcept : thunk_(thunk), size_(size) {}
+
+	/// Invoke the stored functor.
+	void exec()
+	{
+		thunk_(this, ThunkOp::invoke);
+	}
+
+	/// operator() invokes the stored functor.
+	void operator()()
+	{
+		exec();
+	}
+
+  private:
+	template<const size_t TBytes, const size_t TAlign>
+	friend class StaticFunctionRing;
+
+	/// Thunk for the stored functor type.
+	Thunk_t thunk_;
+	/// Size of the record, including the header, in bytes.
+	uint32_t size_;
+	/// Indicates that the functor has been destroyed and the record can be reclaimed.
+	bool released_ = false;
+};
+
+/** Static-memory function queue which packs functors back-to-back in a byte ring.
+ *
+ * StaticFunctionQueue reserves a pool slot sized for the largest expected functor for every
+ * element. StaticFunctionRing instead stores each functor in a size-prefixed record which only
+ * uses the space the functor needs (rounded up to TAlign). Small lambdas and function pointers
+ * use a fraction of a StaticFunctionQueue slot, so many more operations fit in the same RAM.
+ * Records are stored contiguously in FIFO order, so pops walk memory sequentially.
+ *
+ * The interface mirrors StaticFunctionQueue:
+ *
+ * @code
+ * embutil::StaticFunctionRing<1024> q;
+ * q.push([] { printf("Hello\n"); });
+ *
+ * auto op = q.front();
+ * q.pop();
+ *
+ * op->exec();
+ * @endcode
+ *
+ * front() returns a std::unique_ptr which destroys the functor and returns its space to the ring
+ * when it goes out of scope. Records may be released in any order. Space is reclaimed once all
+ * older records have also been released.
+ *
+ * A record never wraps around the end of the buffer. If the record does not fit in the space at
+ * the end of the buffer, that space is skipped until the ring wraps again.
+ *
+ * @note This class is not thread safe. Like StaticFunctionQueue, pushes, pops, and releases of
+ *	front() elements must be protected by the same lock.
+ *
+ * @tparam TBytes The size of the ring buffer, in bytes. Must be a multiple of TAlign.
+ * @tparam TAlign The alignment of each record. Functors with a stricter alignment requirement
+ *	cannot be stored.
+ */
+template<const size_t TBytes, const size_t TAlign = alignof(std::max_align_t)>
+class StaticFunctionRing
+{
+	static_assert(TBytes > 0, "StaticFunctionRing requires TBytes > 0");
+	static_assert(TBytes % TAlign == 0, "TBytes must be a multiple of TAlign");
+	static_assert(TBytes <= UINT32_MAX, "Record offsets are stored as 32-bit values");
+	static_assert(TAlign >= alignof(FuncRecord), "TAlign must satisfy the record alignment");
+
+	/// Round a size up to the record alignment.
+	static constexpr size_t align(size_t size) noexcept
+	{
+		return (size + TAlign - 1) & ~(TAlign - 1);
+	}
+
+	/// Size of the record header, rounded to the record alignment.
+	static constexpr size_t header_size = align(sizeof(FuncRecord));
+
+	/** Return a record to the ring.
+	 *
+	 * This deleter is used with the std::unique_ptr returned by front(). When the record goes out
+	 * of scope, the functor is destroyed and the space is reclaimed.
+	 */
+	struct Releaser
+	{
+		/// The ring which owns the record.
+		StaticFunctionRing* ring;
+
+		/// Release the record.
+		void operator()(FuncRecord* record) const noexcept
+		{
+			ring->release(record);
+		}
+	};
+
+	/// Convenience alias for the unique pointer to the record.
+	using UniqueElementPtr_t = std::unique_ptr<FuncRecord, Releaser>;
+
+  public:
+	/// Default constructor
+	StaticFunctionRing() = default;
+
+	/// Destroy the ring and any functors which are still enqueued.
+	/// @pre All records returned by front() have been released.
+	~StaticFunctionRing() noexcept
+	{
+		while(!empty())
+		{
+			auto op = front();
+			pop();
+		}
+	}
+
+	/// Deleted copy constructor
+	StaticFunctionRing(const StaticFunctionRing&) = delete;
+
+	/// Deleted copy assignment operator
+	auto operator=(const StaticFunctionRing&) -> const StaticFunctionRing& = delete;
+
+	/// Deleted move constructor
+	StaticFunctionRing(StaticFunctionRing&&) = delete;
+
+	/// Deleted move assignment operator
+	auto operator=(StaticFunctionRing&&) -> StaticFunctionRing& = delete;
+
+	/** Get the number of bytes a functor type occupies in the ring.
+	 *
+	 * @tparam TFuncOp The functor type.
+	 * @returns the record size for TFuncOp, including the header.
+	 */
+	template<typename TFuncOp>
+	static constexpr auto record_size() noexcept -> size_t
+	{
+		return header_size + align(sizeof(std::decay_t<TFuncOp>));
+	}
+
+	/** Add a function to the queue if there is space.
+	 *
+	 * @tparam TFuncOp The type of the functor to add to the queue. This template parameter is
+	 * 	automatically deduced by the compiler.
+	 * @param input_op The functor object to add to the queue.
+	 * @returns true if the functor was added, false if there is not enough contiguous space.
+	 */
+	template<typename TFuncOp>
+	auto try_push(TFuncOp&& input_op) noexcept -> bool
+	{
+		using FuncType = std::decay_t<TFuncOp>;
+
+		static_assert(alignof(FuncType) <= TAlign,
+					  "Functor alignment exceeds StaticFunctionRing::TAlign");
+		static_assert(record_size<FuncType>() <= TBytes,
+					  "Functor does not fit in StaticFunctionRing - increase TBytes");
+
+		constexpr size_t size = record_size<FuncType>();
+		auto offset = allocate(size);
+		if(offset == TBytes)
+		{
+			return false;
+		}
+
+		new(&buffer_[offset]) FuncRecord(&thunk<FuncType>, size);
+		new(&buffer_[offset + header_size]) FuncType(std::forward<TFuncOp>(input_op));
+		size_++;
+
+		return true;
+	}
+
+	/** Add a function to the queue.
+	 *
+	 * This function is noexcept because we want our program to abort if we are out of memory.
+	 *
+	 * @tparam TFuncOp The type of the functor to add to the queue. This template parameter is
+	 * 	automatically deduced by the compiler.
+	 * @param input_op The functor object to add to the queue.
+	 */
+	template<typename TFuncOp>
+	void push(TFuncOp&& input_op) noexcept
+	{
+		[[maybe_unused]] bool pushed = try_push(std::forward<TFuncOp>(input_op));
+		assert(pushed && "Could not allocate space for function in ring buffer");
+	}
+
+	/// Remove the next functor from the front of the queue and execute it.
+	void popAndExec() noexcept
+	{
+		auto op = front();
+		pop();
+		op->exec();
+	}
+
+	/** Get the functor at the front of the queue.
+	 *
+	 * @note Because we have a std::unique_ptr, front() can only be called once per functor.
+	 *
+	 * @pre There is an element in the queue, and front() has not been previously called for it.
+	 * @returns a UniqueElementPtr_t to the functor at the front of the queue.
+	 *	Once the UniqueElementPtr_t goes out of scope, the functor is destroyed and the ring
+	 *	recovers the memory.
+	 */
+	auto front() noexcept -> UniqueElementPtr_t
+	{
+		if(read_ == wrap_)
+		{
+			read_ = 0;
+		}
+
+		return UniqueElementPtr_t(record_at(read_), Releaser{this});
+	}
+
+	/** Remove the element at the front of the queue.
+	 *
+	 * @pre There is an element in the queue, and front() has been called for it.
+	 * @post The element has been removed from the queue.
+	 */
+	void pop() noexcept
+	{
+		if(read_ == wrap_)
+		{
+			read_ = 0;
+		}
+
+		read_ += record_at(read_)->size_;
+		size_--;
+	}
+
+	/** Check if the queue is empty.
+	 *
+	 * @returns true if the queue is empty, false otherwise.
+	 */
+	[[nodiscard]] auto empty() const noexcept -> bool
+	{
+		return size() == 0;
+	}
+
+	/** Check the current number of elements in the queue
+	 *
+	 * @returns the number of elements currently stored in the queue.
+	 */
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		return size_;
+	}
+
+	/** Get the total memory consumed by the ring buffer in bytes
+	 *
+	 * @returns the size of the ring buffer in bytes.
+	 */
+	[[nodiscard]] constexpr auto capacity_bytes() const noexcept -> size_t
+	{
+		return TBytes;
+	}
+
+  private:
+	/// Invoke or destroy a functor of type TFuncOp.
+	template<typename TFuncOp>
+	static void thunk(FuncRecord* record, FuncRecord::ThunkOp op)
+	{
+		auto* func = std::launder(
+			reinterpret_cast<TFuncOp*>(reinterpret_cast<std::byte*>(record) + header_size));
+
+		if(op == FuncRecord::ThunkOp::invoke)
+		{
+			(*func)();
+		}
+		else
+		{
+			func->~TFuncOp();
+		}
+	}
+
+	/// Get the record stored at an offset.
+	FuncRecord* record_at(size_t offset) noexcept
+	{
+		return std::launder(reinterpret_cast<FuncRecord*>(&buffer_[offset]));
+	}
+
+	/** Reserve contiguous space for a record.
+	 *
+	 * @param size The size of the record in bytes.
+	 * @returns the offset of the reserved space, or TBytes if there is not enough space.
+	 */
+	auto allocate(size_t size) noexcept -> size_t
+	{
+		if(live_ == 0)
+		{
+			// Start from the beginning of the buffer to maximize contiguous space
+			head_ = tail_ = read_ = 0;
+			wrap_ = TBytes;
+			wrapped_ = false;
+		}
+
+		if(!wrapped_)
+		{
+			if(head_ + size > TBytes)
+			{
+				if(size > tail_)
+				{
+					return TBytes;
+				}
+
+				// Skip the space at the end of the buffer
+				wrap_ = head_;
+				head_ = 0;
+				wrapped_ = true;
+			}
+		}
+		else if(head_ + size > tail_)
+		{
+			return TBytes;
+		}
+
+		auto offset = head_;
+		head_ += size;
+		live_++;
+
+		return offset;
+	}
+
+	/** Destroy a functor and reclaim the space used by released records.
+	 *
+	 * @param record The record to release.
+	 */
+	void release(FuncRecord* record) noexcept
+	{
+		record->thunk_(record, FuncRecord::ThunkOp::destroy);
+		record->released_ = true;
+
+		while(live_ > 0)
+		{
+			if(wrapped_ && tail_ == wrap_)
+			{
+				// The front of the queue may have already reached the skipped space
+				if(read_ == wrap_)
+				{
+					read_ = 0;
+				}
+
+				tail_ = 0;
+				wrap_ = TBytes;
+				wrapped_ = false;
+			}
+
+			auto* oldest = record_at(tail_);
+			if(!oldest->released_)
+			{
+				break;
+			}
+
+			tail_ += oldest->size_;
+			oldest->~FuncRecord();
+			live_--;
+		}
+	}
+
+  private:
+	/// Storage for records.
+	alignas(TAlign) std::byte buffer_[TBytes];
+	/// Offset at which the next record is written.
+	size_t head_ = 0;
+	/// Offset of the oldest record which has not been reclaimed.
+	size_t tail_ = 0;
+	/// Offset of the record at the front of the queue.
+	size_t read_ = 0;
+	/// Offset at which records in the upper part of the buffer end when the ring has wrapped.
+	size_t wrap_ = TBytes;
+	/// Indicates that live records span the end of the buffer.
+	bool wrapped_ = false;
+	/// Number of records in the queue.
+	size_t size_ = 0;
+	/// Number of records which have not been reclaimed (queued, or popped and not released).
+	size_t live_ = 0;
+};
+
+/// @}
+// End FunctionQueue
+
+} // namespace embutil
+
+#endif // FUNCTION_RING_HPP_
@@ -0,0 +1,200 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "function_queue.hpp"
+#include "function_ring.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+using namespace embutil;
+
+#pragma mark - Helper Functions -
+
+static uint8_t test_counter;
+
+static void test_func()
+{
+	test_counter++;
+}
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create function ring", "[utility/function_ring]")
+{
+	StaticFunctionRing<256> fr;
+	CHECK(0 == fr.size());
+	CHECK(true == fr.empty());
+	CHECK(256 == fr.capacity_bytes());
+}
+
+TEST_CASE("Push and pop functions in ring", "[utility/function_ring]")
+{
+	StaticFunctionRing<256> fr;
+	int value = 0;
+	test_counter = 0;
+
+	fr.push(test_func);
+	fr.push([&value] { value += 2; });
+	fr.push(stdext::inplace_function<void()>([&value] { value *= 10; }));
+	CHECK(3 == fr.size());
+
+	fr.popAndExec();
+	fr.popAndExec();
+	fr.popAndExec();
+	CHECK(0 == fr.size());
+	CHECK(1 == test_counter);
+	CHECK(20 == value);
+}
+
+TEST_CASE("Push, manually exec from ring front", "[utility/function_ring]")
+{
+	StaticFunctionRing<256> fr;
+	test_counter = 0;
+
+	fr.push(test_func);
+
+	auto f = fr.front();
+	fr.pop();
+
+	f->exec();
+
+	CHECK(0 == fr.size());
+	CHECK(1 == test_counter);
+}
+
+TEST_CASE("Ring stores more small functors than a function queue of the same size",
+		  "[utility/function_ring]")
+{
+	constexpr size_t queue_elements = 8;
+	constexpr size_t ring_bytes = queue_elements * DefaultStaticQueueLargestSize;
+	StaticFunctionRing<ring_bytes> fr;
+	int value = 0;
+	auto op = [&value] { value++; };
+	size_t count = 0;
+
+	while(fr.try_push(op))
+	{
+		count++;
+	}
+
+	CHECK(count == ring_bytes / StaticFunctionRing<ring_bytes>::record_size<decltype(op)>());
+	CHECK(count > 2 * queue_elements);
+
+	while(!fr.empty())
+	{
+		fr.popAndExec();
+	}
+
+	CHECK(static_cast<int>(count) == value);
+}
+
+TEST_CASE("Ring reclaims space after wrapping", "[utility/function_ring]")
+{
+	using Ring_t = StaticFunctionRing<128>;
+	Ring_t fr;
+	int value = 0;
+	auto op = [&value] { value++; };
+	const size_t per_ring = 128 / Ring_t::record_size<decltype(op)>();
+
+	// Keep one element in flight so the ring never resets to the start of the buffer
+	fr.push(op);
+	for(size_t i = 0; i < 10 * per_ring; i++)
+	{
+		CHECK(fr.try_push(op));
+		fr.popAndExec();
+	}
+
+	CHECK(1 == fr.size());
+	fr.popAndExec();
+	CHECK(static_cast<int>(10 * per_ring + 1) == value);
+}
+
+TEST_CASE("Ring space is reclaimed once older records are released", "[utility/function_ring]")
+{
+	using Ring_t = StaticFunctionRing<128>;
+	Ring_t fr;
+	auto op = [] {};
+	const size_t per_ring = 128 / Ring_t::record_size<decltype(op)>();
+
+	for(size_t i = 0; i < per_ring; i++)
+	{
+		fr.push(op);
+	}
+
+	CHECK_FALSE(fr.try_push(op));
+
+	auto first = fr.front();
+	fr.pop();
+	auto second = fr.front();
+	fr.pop();
+
+	// Releasing a newer record does not free space while an older one is outstanding
+	second.reset();
+	CHECK_FALSE(fr.try_push(op));
+
+	first.reset();
+	CHECK(fr.try_push(op));
+	CHECK(fr.try_push(op));
+	CHECK_FALSE(fr.try_push(op));
+}
+
+TEST_CASE("Ring rewinds past skipped space at the end of the buffer", "[utility/function_ring]")
+{
+	int value = 0;
+	auto op = [&value] { value++; };
+	constexpr size_t record = StaticFunctionRing<256>::record_size<decltype(op)>();
+
+	// Four records fit, and the remaining bytes are skipped when the ring wraps
+	using Ring_t = StaticFunctionRing<4 * record + alignof(std::max_align_t)>;
+	Ring_t fr;
+
+	for(int i = 0; i < 4; i++)
+	{
+		fr.push(op);
+	}
+
+	for(int i = 0; i < 3; i++)
+	{
+		fr.popAndExec();
+	}
+
+	// Wraps to the start of the buffer, skipping the space at the end
+	fr.push(op);
+
+	fr.popAndExec();
+	fr.popAndExec();
+	CHECK(5 == value);
+	CHECK(fr.empty());
+
+	// The ring is still usable after the skipped space has been reclaimed
+	fr.push(op);
+	fr.push(op);
+	fr.popAndExec();
+	fr.push(op);
+	while(!fr.empty())
+	{
+		fr.popAndExec();
+	}
+
+	CHECK(8 == value);
+}
+
+TEST_CASE("Ring destroys captured state", "[utility/function_ring]")
+{
+	auto tracker = std::make_shared<int>(0);
+
+	{
+		StaticFunctionRing<256> fr;
+		fr.push([tracker] { (*tracker)++; });
+		fr.push([tracker] { (*tracker)++; });
+		CHECK(3 == tracker.use_count());
+
+		fr.popAndExec();
+		CHECK(2 == tracker.use_count());
+	}
+
+	CHECK(1 == tracker.use_count());
+	CHECK(1 == *tracker);
+}
@@ -0,0 +1,220 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#include "mpmc_queue.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace embutil;
+
+#pragma mark - Test Cases -
+
+TEST_CASE("Create MPMC queue", "[utility/lock_free_queue/mpmc]")
+{
+	MPMCQueue<int, 10> q;
+
+	CHECK(0 == q.size());
+	CHECK(q.empty());
+	CHECK(10 == q.capacity());
+}
+
+TEST_CASE("MPMC queue is FIFO", "[utility/lock_free_queue/mpmc]")
+{
+	MPMCQueue<int, 4> q;
+	int v = 0;
+
+	CHECK(q.push(1));
+	CHECK(q.push(2));
+	CHECK(q.push(3));
+	CHECK(3 == q.size());
+
+	CHECK(q.pop(v));
+	CHECK(1 == v);
+	CHECK(q.pop(v));
+	CHECK(2 == v);
+	CHECK(q.pop(v));
+	CHECK(3 == v);
+	CHECK_FALSE(q.pop(v));
+}
+
+TEST_CASE("MPMC queue rejects push when full", "[utility/lock_free_queue/mpmc]")
+{
+	MPMCQueue<int, 3> q;
+	int v = 0;
+
+	for(int i = 0; i < 3; i++)
+	{
+		CHECK(q.push(i));
+	}
+
+	CHECK_FALSE(q.push(4));
+
+	// Wrap around the ring several times
+	for(int i = 0; i < 10; i++)
+	{
+		CHECK(q.pop(v));
+		CHECK(q.push(i));
+	}
+
+	CHECK(3 == q.size());
+}
+
+TEST_CASE("MPMC queue destroys remaining elements", "[utility/lock_free_queue/mpmc]")
+{
+	auto tracker = std::make_shared<int>(0);
+
+	{
+		MPMCQueue<std::shared_ptr<int>, 4> q;
+		q.push(tracker);
+		q.push(tracker);
+		CHECK(3 == tracker.use_count());
+	}
+
+	CHECK(1 == tracker.use_count());
+}
+
+TEST_CASE("MPMC queue with concurrent producers and consumers", "[utility/lock_free_queue/mpmc]")
+{
+	constexpr int num_threads = 4;
+	constexpr int items_per_thread = 10000;
+	MPMCQueue<int, 64> q;
+	std::atomic<long> sum = 0;
+	std::atomic<int> consumed = 0;
+	std::vector<std::thread> threads;
+
+	for(int t = 0; t < num_threads; t++)
+	{
+		threads.emplace_back([&q] {
+			for(int i = 1; i <= items_per_thread; i++)
+			{
+				while(!q.push(i))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		threads.emplace_back([&] {
+			int v = 0;
+			while(consumed < num_threads * items_per_thread)
+			{
+				if(q.pop(v))
+				{
+					sum += v;
+					consumed++;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for(auto& t : threads)
+	{
+		t.join();
+	}
+
+	CHECK(num_threads * items_per_thread == consumed);
+	CHECK(static_cast<long>(num_threads) * items_per_thread * (items_per_thread + 1) / 2 == sum);
+	CHECK(q.empty());
+}
+
+TEST_CASE("SPSC queue is FIFO", "[utility/lock_free_queue/spsc]")
+{
+	SPSCQueue<int, 4> q;
+	int v = 0;
+
+	CHECK(q.empty());
+	CHECK(4 == q.capacity());
+
+	CHECK(q.push(1));
+	CHECK(q.push(2));
+	CHECK(q.push(3));
+	CHECK(3 == q.size());
+
+	CHECK(q.pop(v));
+	CHECK(1 == v);
+	CHECK(q.pop(v));
+	CHECK(2 == v);
+	CHECK(q.pop(v));
+	CHECK(3 == v);
+	CHECK_FALSE(q.pop(v));
+}
+
+TEST_CASE("SPSC queue rejects push when full", "[utility/lock_free_queue/spsc]")
+{
+	SPSCQueue<int, 3> q;
+	int v = 0;
+
+	for(int i = 0; i < 3; i++)
+	{
+		CHECK(q.push(i));
+	}
+
+	CHECK_FALSE(q.push(4));
+
+	// Wrap around the ring several times
+	for(int i = 0; i < 10; i++)
+	{
+		CHECK(q.pop(v));
+		CHECK(q.push(i));
+		CHECK(3 == q.size());
+	}
+}
+
+TEST_CASE("SPSC queue destroys remaining elements", "[utility/lock_free_queue/spsc]")
+{
+	auto tracker = std::make_shared<int>(0);
+
+	{
+		SPSCQueue<std::shared_ptr<int>, 4> q;
+		q.push(tracker);
+		q.push(tracker);
+		CHECK(3 == tracker.use_count());
+	}
+
+	CHECK(1 == tracker.use_count());
+}
+
+TEST_CASE("SPSC queue with concurrent producer and consumer", "[utility/lock_free_queue/spsc]")
+{
+	constexpr int num_items = 100000;
+	SPSCQueue<int, 16> q;
+	bool in_order = true;
+
+	std::thread producer([&q] {
+		for(int i = 0; i < num_items; i++)
+		{
+			while(!q.push(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	for(int expected = 0; expected < num_items;)
+	{
+		int v = 0;
+
+		if(q.pop(v))
+		{
+			in_order = in_order && (v == expected);
+			expected++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	producer.join();
+
+	CHECK(in_order);
+	CHECK(q.empty());
+}
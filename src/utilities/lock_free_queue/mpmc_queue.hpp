@@ -0,0 +1,227 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef MPMC_QUEUE_HPP_
+#define MPMC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace embutil
+{
+/// @defgroup LockFreeQueue Lock-free Queues
+/// Bounded queues which can be shared between threads without a lock.
+/// @ingroup FrameworkUtils
+/// @{
+
+/// Assumed size of a cache line, used to keep producer and consumer indices apart.
+inline constexpr size_t LockFreeQueueCacheLineSize = 64;
+
+/** Bounded multi-producer/multi-consumer lock-free queue.
+ *
+ * This queue uses only static memory. Each cell in the ring stores an element along with a
+ * sequence number. The sequence number tells producers whether the cell is free and consumers
+ * whether the cell has been published, so neither side needs a lock. A producer or consumer only
+ * contends with others on a single compare-and-swap of the shared index.
+ *
+ * Elements are constructed in place on push() and destroyed on pop(), so any movable type can be
+ * stored.
+ *
+ * @code
+ * embutil::MPMCQueue<int, 16> q;
+ * q.push(1);
+ *
+ * int v;
+ * if(q.pop(v))
+ * {
+ * 	...
+ * }
+ * @endcode
+ *
+ * @note size() is a snapshot and can be stale by the time the caller uses it.
+ *
+ * @tparam T The element type.
+ * @tparam TSize The maximum number of elements in the queue. TSize must be > 0.
+ */
+template<typename T, const size_t TSize>
+class MPMCQueue
+{
+	static_assert(TSize > 0, "MPMCQueue requires TSize > 0");
+
+	/// Storage cell for a single element.
+	struct Cell
+	{
+		/// Cell sequence number, which encodes whether the cell is empty or published.
+		std::atomic<size_t> sequence;
+
+		/// Uninitialized storage for the element.
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+  public:
+	/// Construct an empty queue.
+	MPMCQueue() noexcept
+	{
+		for(size_t i = 0; i < TSize; i++)
+		{
+			cells_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/// Destroy the queue and any elements which are still stored.
+	~MPMCQueue() noexcept
+	{
+		auto tail = enqueue_pos_.load(std::memory_order_acquire);
+
+		for(auto pos = dequeue_pos_.load(std::memory_order_acquire); pos != tail; pos++)
+		{
+			std::launder(reinterpret_cast<T*>(&cells_[pos % TSize].storage))->~T();
+		}
+	}
+
+	/// Deleted copy constructor
+	MPMCQueue(const MPMCQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	auto operator=(const MPMCQueue&) -> const MPMCQueue& = delete;
+
+	/// Deleted move constructor
+	MPMCQueue(MPMCQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	auto operator=(MPMCQueue&&) -> MPMCQueue& = delete;
+
+	/** Add an element to the queue.
+	 *
+	 * @param value The element to add. It is only moved from if the push succeeds.
+	 * @returns true if the element was added, false if the queue is full.
+	 */
+	template<typename TValue>
+	auto push(TValue&& value) noexcept -> bool
+	{
+		Cell* cell;
+		size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+		while(true)
+		{
+			cell = &cells_[pos % TSize];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+			if(diff == 0)
+			{
+				if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if(diff < 0)
+			{
+				// The cell has not yet been consumed from the previous lap: the queue is full
+				return false;
+			}
+			else
+			{
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+
+		new(&cell->storage) T(std::forward<TValue>(value));
+		cell->sequence.store(pos + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/** Remove the element at the front of the queue.
+	 *
+	 * @param value Receives the element which was removed.
+	 * @returns true if an element was removed, false if the queue is empty.
+	 */
+	auto pop(T& value) noexcept -> bool
+	{
+		Cell* cell;
+		size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+		while(true)
+		{
+			cell = &cells_[pos % TSize];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+			if(diff == 0)
+			{
+				if(dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if(diff < 0)
+			{
+				// The cell has not been published yet: the queue is empty
+				return false;
+			}
+			else
+			{
+				pos = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+
+		auto* element = std::launder(reinterpret_cast<T*>(&cell->storage));
+		value = std::move(*element);
+		element->~T();
+		cell->sequence.store(pos + TSize, std::memory_order_release);
+
+		return true;
+	}
+
+	/** Check if the queue is empty.
+	 *
+	 * @returns true if the queue is empty, false otherwise.
+	 */
+	[[nodiscard]] auto empty() const noexcept -> bool
+	{
+		return size() == 0;
+	}
+
+	/** Get the approximate number of elements in the queue.
+	 *
+	 * @returns the number of elements in the queue at the time of the call.
+	 */
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		auto head = dequeue_pos_.load(std::memory_order_acquire);
+		auto tail = enqueue_pos_.load(std::memory_order_acquire);
+
+		return (tail > head) ? (tail - head) : 0;
+	}
+
+	/** Get the capacity in elements
+	 *
+	 * @returns the number of elements that the queue can support.
+	 */
+	[[nodiscard]] constexpr auto capacity() const noexcept -> size_t
+	{
+		return TSize;
+	}
+
+  private:
+	/// Element storage ring.
+	Cell cells_[TSize];
+
+	/// Next position to be written by a producer.
+	alignas(LockFreeQueueCacheLineSize) std::atomic<size_t> enqueue_pos_{0};
+
+	/// Next position to be read by a consumer.
+	alignas(LockFreeQueueCacheLineSize) std::atomic<size_t> dequeue_pos_{0};
+};
+
+/// @}
+// End LockFreeQueue
+
+} // namespace embutil
+
+#endif // MPMC_QUEUE_HPP_
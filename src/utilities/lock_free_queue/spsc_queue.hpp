@@ -0,0 +1,188 @@
+// Copyright 2020 Embedded Artistry LLC
+// SPDX-License-Identifier: GPL-3.0-only OR Embedded Virtual Machine Commercial License
+
+#ifndef SPSC_QUEUE_HPP_
+#define SPSC_QUEUE_HPP_
+
+#include "mpmc_queue.hpp"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace embutil
+{
+/// @addtogroup LockFreeQueue
+/// @{
+
+/** Bounded single-producer/single-consumer wait-free queue.
+ *
+ * This queue uses only static memory. The producer owns the write index and the consumer owns
+ * the read index. Each side publishes its index with a release store and reads the other side's
+ * index with an acquire load, so push() and pop() complete in a bounded number of steps without
+ * locks or compare-and-swap loops.
+ *
+ * Because the producer never waits for the consumer, push() is safe to call from an interrupt
+ * handler without masking interrupts, provided that only one context ever pushes.
+ *
+ * @code
+ * embutil::SPSCQueue<int, 16> q;
+ * q.push(1); // Producer context
+ *
+ * int v;
+ * if(q.pop(v)) // Consumer context
+ * {
+ * 	...
+ * }
+ * @endcode
+ *
+ * @note Only one thread (or interrupt) may push, and only one thread may pop. Use MPMCQueue if
+ *	there are multiple producers or consumers.
+ * @note size() is a snapshot and can be stale by the time the caller uses it.
+ *
+ * @tparam T The element type.
+ * @tparam TSize The maximum number of elements in the queue. TSize must be > 0.
+ */
+template<typename T, const size_t TSize>
+class SPSCQueue
+{
+	static_assert(TSize > 0, "SPSCQueue requires TSize > 0");
+
+	/// One slot is always left empty to distinguish a full queue from an empty queue.
+	static constexpr size_t TSlots = TSize + 1;
+
+	/// Storage slot for a single element.
+	struct Slot
+	{
+		/// Uninitialized storage for the element.
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+  public:
+	/// Construct an empty queue.
+	SPSCQueue() noexcept = default;
+
+	/// Destroy the queue and any elements which are still stored.
+	~SPSCQueue() noexcept
+	{
+		auto tail = write_.load(std::memory_order_acquire);
+
+		for(auto pos = read_.load(std::memory_order_acquire); pos != tail; pos = next(pos))
+		{
+			std::launder(reinterpret_cast<T*>(&slots_[pos].storage))->~T();
+		}
+	}
+
+	/// Deleted copy constructor
+	SPSCQueue(const SPSCQueue&) = delete;
+
+	/// Deleted copy assignment operator
+	auto operator=(const SPSCQueue&) -> const SPSCQueue& = delete;
+
+	/// Deleted move constructor
+	SPSCQueue(SPSCQueue&&) = delete;
+
+	/// Deleted move assignment operator
+	auto operator=(SPSCQueue&&) -> SPSCQueue& = delete;
+
+	/** Add an element to the queue.
+	 *
+	 * @pre Called from the producer context only.
+	 * @param value The element to add. It is only moved from if the push succeeds.
+	 * @returns true if the element was added, false if the queue is full.
+	 */
+	template<typename TValue>
+	auto push(TValue&& value) noexcept -> bool
+	{
+		auto pos = write_.load(std::memory_order_relaxed);
+		auto next_pos = next(pos);
+
+		if(next_pos == read_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		new(&slots_[pos].storage) T(std::forward<TValue>(value));
+		write_.store(next_pos, std::memory_order_release);
+
+		return true;
+	}
+
+	/** Remove the element at the front of the queue.
+	 *
+	 * @pre Called from the consumer context only.
+	 * @param value Receives the element which was removed.
+	 * @returns true if an element was removed, false if the queue is empty.
+	 */
+	auto pop(T& value) noexcept -> bool
+	{
+		auto pos = read_.load(std::memory_order_relaxed);
+
+		if(pos == write_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		auto* element = std::launder(reinterpret_cast<T*>(&slots_[pos].storage));
+		value = std::move(*element);
+		element->~T();
+		read_.store(next(pos), std::memory_order_release);
+
+		return true;
+	}
+
+	/** Check if the queue is empty.
+	 *
+	 * @returns true if the queue is empty, false otherwise.
+	 */
+	[[nodiscard]] auto empty() const noexcept -> bool
+	{
+		return read_.load(std::memory_order_acquire) == write_.load(std::memory_order_acquire);
+	}
+
+	/** Get the approximate number of elements in the queue.
+	 *
+	 * @returns the number of elements in the queue at the time of the call.
+	 */
+	[[nodiscard]] auto size() const noexcept -> size_t
+	{
+		auto head = read_.load(std::memory_order_acquire);
+		auto tail = write_.load(std::memory_order_acquire);
+
+		return (tail >= head) ? (tail - head) : (TSlots - head + tail);
+	}
+
+	/** Get the capacity in elements
+	 *
+	 * @returns the number of elements that the queue can support.
+	 */
+	[[nodiscard]] constexpr auto capacity() const noexcept -> size_t
+	{
+		return TSize;
+	}
+
+  private:
+	/// Get the slot index which follows pos.
+	static constexpr auto next(size_t pos) noexcept -> size_t
+	{
+		return (pos + 1 == TSlots) ? 0 : pos + 1;
+	}
+
+  private:
+	/// Element storage ring.
+	Slot slots_[TSlots];
+
+	/// Next slot to be written by the producer.
+	alignas(LockFreeQueueCacheLineSize) std::atomic<size_t> write_{0};
+
+	/// Next slot to be read by the consumer.
+	alignas(LockFreeQueueCacheLineSize) std::atomic<size_t> read_{0};
+};
+
+/// @}
+// End LockFreeQueue
+
+} // namespace embutil
+
+#endif // SPSC_QUEUE_HPP_